@@ -1,12 +1,12 @@
 template <class T>
-vector<T> get_F_t(vector<int> fleet_season, int age, int year, array<T> FAA){
+vector<T> get_F_t(const vector<int>& fleet_season, int age, int year, array<T>& FAA){
   vector<T> F_t(FAA.dim(0));
   for(int f = 0; f < FAA.dim(0); f++) if(fleet_season(f)) F_t(f) = FAA(f,year,age);
   return F_t;
 }
 
 template <class T>
-vector<T> get_F_t(vector<int> fleet_season, int age, matrix<T> FAA){
+vector<T> get_F_t(const vector<int>& fleet_season, int age, const matrix<T>& FAA){
   vector<T> F_t(FAA.rows());
   for(int f = 0; f < FAA.rows(); f++) if(fleet_season(f)) F_t(f) = FAA(f,age);
   return F_t;
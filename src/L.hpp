@@ -47,7 +47,6 @@ vector<Type> get_nll_L(vector<int> L_model, matrix<Type> L_pars, matrix<Type> re
         L_pars: fixed effects parameters for extra mortality rate
             re: matrix of random effects to possibly use
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int nr = L_model.size();
 
   vector<Type> nll(nr);
@@ -58,7 +57,8 @@ vector<Type> get_nll_L(vector<int> L_model, matrix<Type> L_pars, matrix<Type> re
     Type mu = exp(L_pars(r,0));
     Type sig = exp(L_pars(r,1));
     Type rho = geninvlogit(L_pars(r,2),Type(-1),Type(1),Type(1)); //rho_trans(L_pars(r,2));
-    nll(r) += SCALE(AR1(rho), sig)(re_r-mu);
+    vector<Type> dev_r = re_r-mu;
+    nll(r) += dar1_re(dev_r, rho, sig);
   }
   return(nll);
 }
@@ -72,7 +72,6 @@ matrix<Type> simulate_L_re(vector<int> L_model, matrix<Type> L_pars, matrix<Type
         L_pars: fixed effects parameters for extra mortality rate
             re: matrix of random effects to possibly use
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int nr = L_model.size();
 
   matrix<Type> re_sim = re;
@@ -83,8 +82,7 @@ matrix<Type> simulate_L_re(vector<int> L_model, matrix<Type> L_pars, matrix<Type
     Type mu = exp(L_pars(r,0));
     Type sig = exp(L_pars(r,1));
     Type rho = geninvlogit(L_pars(r,2),Type(-1),Type(1),Type(1)); //rho_trans(L_pars(r,2));
-    AR1(rho).simulate(re_r);
-    re_r *= sig;
+    re_r = rar1_re(re_r, rho, sig);
     for(int i = 0; i < re_r.size(); i++) re_sim(i,r) = mu + re_r(i);
   }
   return(re_sim);
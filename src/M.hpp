@@ -9,7 +9,6 @@ matrix<Type> get_nll_M(array<Type> M_repars, matrix<int> M_re_model, int M_model
             n_M_re: (n_stocks x n_regions) number of random effects (e.g., number of age classes or number of M=f(WAA) pars) each year), max(n_M_re)<=n_ages)
          years_use: is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = M_re.dim(0);
   int n_regions = M_re.dim(1);
   int n_y = years_use.size();
@@ -23,21 +22,21 @@ matrix<Type> get_nll_M(array<Type> M_repars, matrix<int> M_re_model, int M_model
       Type rho_M_y = geninvlogit(M_repars(s,r,2),Type(-1),Type(1),Type(1));//using scale =1 ,2 is legacy
       Type Sigma_M;
       // likelihood of M deviations, M_re
-      array<Type> M_re_r_s(n_y,n_M_re(s,r));
+      matrix<Type> M_re_r_s(n_y,n_M_re(s,r));
       M_re_r_s.setZero();
       for(int y = 0; y < n_y; y++)for(int a = 0; a < n_M_re(s,r); a++) M_re_r_s(y,a) = M_re(s,r,years_use(y),a); //first n_M_re(s,r) columns
       if(M_re_model(s,r) == 4){ //2D AR1: age, year (could be iid)
         Sigma_M = pow(pow(sigma_M,2) / ((1-pow(rho_M_y,2))*(1-pow(rho_M_a,2))),0.5);
-        nll_M(s,r) += SCALE(SEPARABLE(AR1(rho_M_a),AR1(rho_M_y)), Sigma_M)(M_re_r_s); // must be array, not matrix!
+        nll_M(s,r) += d2dar1_re(M_re_r_s, rho_M_y, rho_M_a, Sigma_M);
       } else {
         if(M_re_model(s,r) == 2){ // 1D ar1_a
-          vector<Type> Mre0 = M_re_r_s.matrix().row(0);
+          vector<Type> Mre0 = M_re_r_s.row(0);
           Sigma_M = pow(pow(sigma_M,2) / (1-pow(rho_M_a,2)),0.5);
-          nll_M(s,r) += SCALE(AR1(rho_M_a), Sigma_M)(Mre0);
+          nll_M(s,r) += dar1_re(Mre0, rho_M_a, Sigma_M);
         } else { // M_re_model(s,r) = 3, 1D ar1_y
-          vector<Type> Mre0 = M_re_r_s.matrix().col(0); //just first column
+          vector<Type> Mre0 = M_re_r_s.col(0); //just first column
           Sigma_M = pow(pow(sigma_M,2) / (1-pow(rho_M_y,2)),0.5);
-          nll_M(s,r) += SCALE(AR1(rho_M_y), Sigma_M)(Mre0);
+          nll_M(s,r) += dar1_re(Mre0, rho_M_y, Sigma_M);
         }
       }
     }
@@ -57,7 +56,6 @@ array<Type> simulate_M_re(array<Type> M_repars, matrix<int> M_re_model, int M_mo
             n_M_re: (n_stocks x n_regions) number of random effects (e.g., number of age classes or number of M=f(WAA) pars) each year), max(n_M_re)<=n_ages)
          years_use: is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = M_re.dim(0);
   int n_regions = M_re.dim(1);
   //int n_ages = M_re.dim(3);
@@ -73,25 +71,25 @@ array<Type> simulate_M_re(array<Type> M_repars, matrix<int> M_re_model, int M_mo
       Type rho_M_y = geninvlogit(M_repars(s,r,2),Type(-1),Type(1),Type(1));//using scale =1 ,2 is legacy
       Type Sigma_M;
       // likelihood of M deviations, M_re
-      array<Type> M_re_r_s(n_y,n_M_re(s,r));
+      matrix<Type> M_re_r_s(n_y,n_M_re(s,r));
       M_re_r_s.setZero();
       if(M_re_model(s,r) == 4){ //2D AR1: age, year (could be iid)
         Sigma_M = pow(pow(sigma_M,2) / ((1-pow(rho_M_y,2))*(1-pow(rho_M_a,2))),0.5);
-        SEPARABLE(AR1(rho_M_a),AR1(rho_M_y)).simulate(M_re_r_s); // must be array, not matrix!
-        for(int y = 0; y < n_y; y++)for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = M_re_r_s(y,a)*Sigma_M;
+        M_re_r_s = r2dar1_re(M_re_r_s, rho_M_y, rho_M_a, Sigma_M);
+        for(int y = 0; y < n_y; y++)for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = M_re_r_s(y,a);
       } else {
         if(M_re_model(s,r) == 2){ // 1D ar1_a
-          vector<Type> Mre0 = M_re_r_s.matrix().row(0);
+          vector<Type> Mre0 = M_re_r_s.row(0);
           Sigma_M = pow(pow(sigma_M,2) / (1-pow(rho_M_a,2)),0.5);
-          AR1(rho_M_a).simulate(Mre0);
+          Mre0 = rar1_re(Mre0, rho_M_a, Sigma_M);
           //all years mapped to the same age-specific RE
-          for(int y = 0; y < n_y; y++) for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = Mre0(a)*Sigma_M;
+          for(int y = 0; y < n_y; y++) for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = Mre0(a);
         } else { // M_re_model(s,r) = 3, 1D ar1_y
-          vector<Type> Mre0 = M_re_r_s.matrix().col(0);
+          vector<Type> Mre0 = M_re_r_s.col(0);
           Sigma_M = pow(pow(sigma_M,2) / (1-pow(rho_M_y,2)),0.5);
-          AR1(rho_M_a).simulate(Mre0);
+          Mre0 = rar1_re(Mre0, rho_M_y, Sigma_M);
           //all ages mapped to the same annual RE
-          for(int y = 0; y < n_y; y++) for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = Mre0(y)*Sigma_M;
+          for(int y = 0; y < n_y; y++) for(int a = 0; a < n_M_re(s,r); a++) sim_M_re(s,r,years_use(y),a) = Mre0(y);
         }
       }
     }
@@ -259,6 +257,31 @@ array<Type> get_log_M(array<Type>M_re, array<int> M_re_index, int M_model, int n
   return log_M; 
 }
 
+template<class Type>
+matrix<int> get_M_by_year(matrix<int> M_re_model, int M_model, array<Type> waa, vector<int> waa_pointer, array<int> Ecov_how){
+  /* 
+    0/1 for each stock and region: whether log_M (from get_log_M) can differ among years given the configuration.
+    When 0, all years (including projection years) share the log_M of the first year.
+         M_re_model: (n_stocks x n_regions) 1: no RE, 2: RE for age (constant by year), 3: RE for year, 4: 2D (age, year)
+            M_model: 1: M= f(age), 2: M = f(WAA)
+                waa: (at least(n_fleets + n_indices + n_stocks + 1(totcatch)) x n_years x n_ages_model) weight at age
+        waa_pointer: n_stocks, which index in first dimension to use if M_model = 2
+           Ecov_how: n_Ecov x n_stocks x n_ages x n_regions: 0/1 values indicating to use effects on natural mortality at age.
+  */
+  int n_stocks = M_re_model.rows();
+  int n_regions = M_re_model.cols();
+  matrix<int> M_by_year(n_stocks, n_regions);
+  M_by_year.setZero();
+  for(int s = 0; s < n_stocks; s++) for(int r = 0; r < n_regions; r++){
+    if(M_re_model(s,r) > 2) M_by_year(s,r) = 1;
+    for(int i = 0; i < Ecov_how.dim(0); i++) for(int a = 0; a < Ecov_how.dim(2); a++) if(Ecov_how(i,s,a,r) == 1) M_by_year(s,r) = 1;
+    if(M_model == 2) for(int y = 1; y < waa.dim(1); y++) for(int a = 0; a < waa.dim(2); a++) {
+      if(asDouble(waa(waa_pointer(s)-1,y,a)) != asDouble(waa(waa_pointer(s)-1,0,a))) M_by_year(s,r) = 1; //data
+    }
+  }
+  return M_by_year;
+}
+
 template<class Type>
 array<Type> get_log_avg_M(array<Type> log_M, vector<int> years_M) {
   array<Type> M(log_M.dim(0),log_M.dim(1),log_M.dim(3));
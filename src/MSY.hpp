@@ -333,11 +333,11 @@ struct sr_yield_gradient_spatial {
 //takes a single year of values for inputs (reduce dimensions appropriately)
 //returns just the "solved" log_Fmsy value
 template <class Type>
-Type get_FMSY(vector<Type> a, vector<Type> b, vector<int> spawn_seasons, vector<int> spawn_regions, vector<int> fleet_regions,
-  matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, vector<Type> ssbfrac, array<Type> sel, array<Type> log_M, array<Type> mu, 
-  vector<Type> L, array<Type> mat,  array<Type> waassb, array<Type> waacatch,
-  vector<Type> fracyr_seasons, vector<int> recruit_model, int small_dim, Type F_init, int n_iter, int bias_correct, 
-  array<Type> marg_NAA_sigma, int trace = 0) {
+Type get_FMSY(const vector<Type>& a, const vector<Type>& b, const vector<int>& spawn_seasons, const vector<int>& spawn_regions, const vector<int>& fleet_regions,
+  const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& ssbfrac, array<Type>& sel, array<Type>& log_M, array<Type>& mu, 
+  const vector<Type>& L, array<Type>& mat,  array<Type>& waassb, array<Type>& waacatch,
+  const vector<Type>& fracyr_seasons, const vector<int>& recruit_model, int small_dim, Type F_init, int n_iter, int bias_correct, 
+  array<Type>& marg_NAA_sigma, int trace = 0) {
   int n = n_iter;
   vector<Type> log_FMSY_i(1);
   vector<Type> log_FMSY_iter(n);
@@ -357,12 +357,12 @@ Type get_FMSY(vector<Type> a, vector<Type> b, vector<int> spawn_seasons, vector<
 
 //returns annual values of 
 template <class Type>
-vector<Type> get_log_FMSY(array<Type> FAA, vector<int> fleet_regions, matrix<int> fleet_seasons, 
-  vector<int> spawn_seasons, vector<int> spawn_regions, array<int> can_move, vector<int> mig_type, vector<Type> fracyr_seasons, 
-  vector<int> which_F_age, vector<int> recruit_model, matrix<Type> log_a, matrix<Type> log_b, 
-  matrix<Type> fracyr_SSB, array<Type> log_M, array<Type> mu, matrix<Type> L, array<Type> waa_ssb, array<Type> waa_catch, 
-  array<Type> mature, int small_dim, vector<Type> FMSY_init, int bias_correct, 
-  array<Type> marg_NAA_sigma, int trace = 0){
+vector<Type> get_log_FMSY(array<Type>& FAA, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, 
+  const vector<int>& spawn_seasons, const vector<int>& spawn_regions, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& fracyr_seasons, 
+  const vector<int>& which_F_age, const vector<int>& recruit_model, const matrix<Type>& log_a, const matrix<Type>& log_b, 
+  const matrix<Type>& fracyr_SSB, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L, array<Type>& waa_ssb, array<Type>& waa_catch, 
+  array<Type>& mature, int small_dim, const vector<Type>& FMSY_init, int bias_correct, 
+  array<Type>& marg_NAA_sigma, int trace = 0){
 
   int n_years_pop = waa_ssb.dim(1);
   vector<int> yvec(1);
@@ -399,26 +399,26 @@ vector<Type> get_log_FMSY(array<Type> FAA, vector<int> fleet_regions, matrix<int
 
 template <class Type>
 vector< matrix <Type> > get_MSY_res(
-  vector<int> recruit_model,
-  matrix<Type> log_SR_a,
-  matrix<Type> log_SR_b,
-  array<Type> log_M, 
-  array<Type> FAA, 
-  vector<int> spawn_seasons,  
-  vector<int> spawn_regions,
-  vector<int> fleet_regions, 
-  matrix<int> fleet_seasons,
-  vector<Type> fracyr_seasons,
-  array<int> can_move,
-  array<int> must_move,
-  vector<int> mig_type,
-  array<Type> trans_mu_base, 
-  matrix<Type> L,
-  int which_F_age, array<Type> waa_ssb, array<Type> waa_catch, 
-  array<Type> mature, matrix<Type> fracyr_SSB, Type F_init, 
-  vector<int> years_M, vector<int> years_mu, vector<int> years_L, vector<int> years_mat, vector<int> years_sel, 
-  vector<int> years_waa_ssb, vector<int> years_waa_catch, vector<int> years_SR_ab, int bias_correct, 
-  array<Type> marg_NAA_sigma, int small_dim, int trace = 0, int n_iter = 10) {
+  const vector<int>& recruit_model,
+  const matrix<Type>& log_SR_a,
+  const matrix<Type>& log_SR_b,
+  array<Type>& log_M, 
+  array<Type>& FAA, 
+  const vector<int>& spawn_seasons,  
+  const vector<int>& spawn_regions,
+  const vector<int>& fleet_regions, 
+  const matrix<int>& fleet_seasons,
+  const vector<Type>& fracyr_seasons,
+  array<int>& can_move,
+  array<int>& must_move,
+  const vector<int>& mig_type,
+  array<Type>& trans_mu_base, 
+  const matrix<Type>& L,
+  int which_F_age, array<Type>& waa_ssb, array<Type>& waa_catch, 
+  array<Type>& mature, const matrix<Type>& fracyr_SSB, Type F_init, 
+  const vector<int>& years_M, const vector<int>& years_mu, const vector<int>& years_L, const vector<int>& years_mat, const vector<int>& years_sel, 
+  const vector<int>& years_waa_ssb, const vector<int>& years_waa_catch, const vector<int>& years_SR_ab, int bias_correct, 
+  array<Type>& marg_NAA_sigma, int small_dim, int trace = 0, int n_iter = 10) {
   // if(years_M(0) == 39) trace = 1;
   if(trace) see("inside get_MSY_res");
   int n = n_iter;
@@ -556,25 +556,25 @@ vector< matrix <Type> > get_MSY_res(
 
 template <class Type>
 vector< array <Type> > get_annual_MSY_res(
-  vector<int> recruit_model,
-  matrix<Type> log_SR_a,
-  matrix<Type> log_SR_b,
-  array<Type> log_M, 
-  array<Type> FAA, 
-  vector<int> spawn_seasons,  
-  vector<int> spawn_regions,
-  vector<int> fleet_regions, 
-  matrix<int> fleet_seasons,
-  vector<Type> fracyr_seasons,
-  array<int> can_move,
-  array<int> must_move,
-  vector<int> mig_type,
-  array<Type> trans_mu_base, 
-  matrix<Type> L,
-  vector<int> which_F_age, array<Type> waa_ssb, array<Type> waa_catch, 
-  array<Type> mature, matrix<Type> fracyr_SSB, vector<Type> F_init, 
+  const vector<int>& recruit_model,
+  const matrix<Type>& log_SR_a,
+  const matrix<Type>& log_SR_b,
+  array<Type>& log_M, 
+  array<Type>& FAA, 
+  const vector<int>& spawn_seasons,  
+  const vector<int>& spawn_regions,
+  const vector<int>& fleet_regions, 
+  const matrix<int>& fleet_seasons,
+  const vector<Type>& fracyr_seasons,
+  array<int>& can_move,
+  array<int>& must_move,
+  const vector<int>& mig_type,
+  array<Type>& trans_mu_base, 
+  const matrix<Type>& L,
+  const vector<int>& which_F_age, array<Type>& waa_ssb, array<Type>& waa_catch, 
+  array<Type>& mature, const matrix<Type>& fracyr_SSB, const vector<Type>& F_init, 
   int small_dim, int bias_correct, 
-  array<Type> marg_NAA_sigma, 
+  array<Type>& marg_NAA_sigma, 
   int trace = 0, int n_iter = 10) {
   if(trace) see("begin get_annual_MSY_res");
   int ny = which_F_age.size();
@@ -45,7 +45,6 @@ matrix<Type> get_nll_N1(vector<int> N1_model, array<Type>log_N1, array<Type> N1_
       NAA_where: n_stocks x n_regions x n_ages: 0/1 whether NAA exists in region at beginning of year. Also controls inclusion of any RE in nll.
   */
   //AR1 RE for N1 if N1_model = 2, mapped appropriately on R side
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = log_N1.dim(0);
   int n_regions = log_N1.dim(1);
   int n_ages = log_N1.dim(2);
@@ -68,7 +67,7 @@ matrix<Type> get_nll_N1(vector<int> N1_model, array<Type>log_N1, array<Type> N1_
           a_count++;
         } 
       }
-      nll(s,r) += SCALE(AR1(rho), sigma)(re_sr);
+      nll(s,r) += dar1_re(re_sr, rho, sigma);
     }
   }
   return(nll);
@@ -86,7 +85,6 @@ array<Type> simulate_log_N1(vector<int> N1_model, array<Type>log_N1, array<Type>
       NAA_where: n_stocks x n_regions x n_ages: 0/1 whether NAA exists in region at beginning of year. Also controls inclusion of any RE in nll.
   */
   //only used if N1_model = 2
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = log_N1.dim(0);
   int n_regions = log_N1.dim(1);
   int n_ages = log_N1.dim(2);
@@ -94,18 +92,17 @@ array<Type> simulate_log_N1(vector<int> N1_model, array<Type>log_N1, array<Type>
   sim_log_N1.setZero();
   for(int s = 0; s < n_stocks; s++) if(N1_model(s) ==2)  for(int r = 0; r < n_regions; r++) if(NAA_where(s,r,0)){
     Type mu = N1_repars(s,r,0);
-    Type sigma = exp(N1_repars(s,r,1)); //marginal variance
     Type rho = geninvlogit(N1_repars(s,r,2),Type(-1),Type(1),Type(1));
+    Type sigma = exp(N1_repars(s,r,1)) * pow(1 - pow(rho,2),-0.5); //marginal variance, as in get_nll_N1
     vector<Type> re_sr(n_ages);
-    AR1(rho).simulate(re_sr);
-    re_sr *= sigma;
+    re_sr = rar1_re(re_sr, rho, sigma);
     for(int a = 0; a < n_ages; a++) sim_log_N1(s,r,a) = re_sr(a) + mu;
   }
   return(sim_log_N1);
 }
 
 template <class Type>
-vector<Type> get_SSB_y(int y, matrix<Type>NAA_spawn_y, array<Type> waa_ssb, array<Type> mature){
+vector<Type> get_SSB_y(int y, const matrix<Type>& NAA_spawn_y, array<Type>& waa_ssb, array<Type>& mature){
   /*
     provide annual SSB for each stock.
                     y: year index
@@ -140,7 +137,7 @@ vector<Type> get_SSB_y(int y, matrix<Type>NAA_spawn_y, array<Type> waa_ssb, arra
 }
 
 template <class Type>
-matrix<Type> get_SSB(array<Type>NAA_spawn, array<Type> waa_ssb, array<Type> mature){
+matrix<Type> get_SSB(array<Type>& NAA_spawn, array<Type>& waa_ssb, array<Type>& mature){
   /*
     provide annual SSB for each stock.
               NAA_spawn: n_stocks x n_years_pop x n_ages; numbers at age at time of spawning 
@@ -162,11 +159,11 @@ matrix<Type> get_SSB(array<Type>NAA_spawn, array<Type> waa_ssb, array<Type> matu
 }
 
 template <class Type>
-array<Type> get_NAA_1(vector<int> N1_model, array<Type> log_N1, array<int> NAA_where, array<Type> log_M, array<Type> FAA, 
-  vector<int> which_F_age, vector<int> spawn_regions, 
-  vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, array<Type> mu, 
-  matrix<Type> L, vector<Type> fracyr_seasons, 
-  vector<int> avg_years_ind, int small_dim) {
+array<Type> get_NAA_1(const vector<int>& N1_model, array<Type>& log_N1, array<int>& NAA_where, array<Type>& log_M, array<Type>& FAA, 
+  const vector<int>& which_F_age, const vector<int>& spawn_regions, 
+  const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, array<Type>& mu, 
+  const matrix<Type>& L, const vector<Type>& fracyr_seasons, 
+  const vector<int>& avg_years_ind, int small_dim) {
   /* 
     get population age structure for the first year
              N1_model: (n_stocks) 0: just age-specific numbers at age, 1: 2 pars: log_N_{1,1}, log_F0, age-structure defined by equilibrium NAA calculations, 2: AR1 random effect
@@ -222,11 +219,11 @@ array<Type> get_NAA_1(vector<int> N1_model, array<Type> log_N1, array<int> NAA_w
 
 ///////////////////THIS IS JUST TO return the components that go into creating equilibrium NAA for that option for initial numbers at age!!!!!!!!!!!!!!!
 template <class Type>
-vector< array<Type>> get_eq_NAA_components(vector<int> N1_model, array<Type> log_N1, array<int> NAA_where, array<Type> log_M, array<Type> FAA, 
-  vector<int> which_F_age, vector<int> spawn_regions, 
-  vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, array<Type> mu, 
-  matrix<Type> L, vector<Type> fracyr_seasons, 
-  vector<int> avg_years_ind, int small_dim) {
+vector< array<Type>> get_eq_NAA_components(const vector<int>& N1_model, array<Type>& log_N1, array<int>& NAA_where, array<Type>& log_M, array<Type>& FAA, 
+  const vector<int>& which_F_age, const vector<int>& spawn_regions, 
+  const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, array<Type>& mu, 
+  const matrix<Type>& L, const vector<Type>& fracyr_seasons, 
+  const vector<int>& avg_years_ind, int small_dim) {
 
   int n_stocks = log_N1.dim(0);
   int n_fleets = FAA.dim(0);
@@ -260,12 +257,12 @@ vector< array<Type>> get_eq_NAA_components(vector<int> N1_model, array<Type> log
 
 
 template <class Type>
-array<Type> get_NAA_y(int y, vector<int> NAA_re_model, array<Type> log_NAA, vector<int> N1_model, array<Type> log_N1, array<int> NAA_where, array<Type> log_M, 
-  array<Type> FAA, vector<int> which_F_age, 
-  vector<int> spawn_regions,
-  vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, array<Type> mu, 
-  array<Type> L, vector<Type> fracyr_seasons, 
-  vector<int> avg_years_ind, int small_dim){
+array<Type> get_NAA_y(int y, const vector<int>& NAA_re_model, array<Type>& log_NAA, const vector<int>& N1_model, array<Type>& log_N1, array<int>& NAA_where, array<Type>& log_M, 
+  array<Type>& FAA, const vector<int>& which_F_age, 
+  const vector<int>& spawn_regions,
+  const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, array<Type>& mu, 
+  array<Type>& L, const vector<Type>& fracyr_seasons, 
+  const vector<int>& avg_years_ind, int small_dim){
   /*
             NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
   */
@@ -316,7 +313,7 @@ array<Type> get_NAA_y(int y, vector<int> NAA_re_model, array<Type> log_NAA, vect
 }
 
 template <class Type>
-matrix<Type> get_NAA_spawn_y(int y, array<Type> NAA_y, array<Type> annual_SAA_spawn, vector<int> spawn_regions, int move_dyn){
+matrix<Type> get_NAA_spawn_y(int y, array<Type>& NAA_y, array<Type>& annual_SAA_spawn, const vector<int>& spawn_regions, int move_dyn){
   int n_stocks = NAA_y.dim(0);
   int n_ages = NAA_y.dim(2);
   int n_regions = NAA_y.dim(1);
@@ -344,7 +341,7 @@ matrix<Type> get_NAA_spawn_y(int y, array<Type> NAA_y, array<Type> annual_SAA_sp
 }
 
 template <class Type>
-array<Type> get_NAA_spawn(array<Type> NAA, array<Type> annual_SAA_spawn, vector<int> spawn_regions, int move_dyn) {
+array<Type> get_NAA_spawn(array<Type>& NAA, array<Type>& annual_SAA_spawn, const vector<int>& spawn_regions, int move_dyn) {
   int n_stocks = NAA.dim(0);
   int n_regions = NAA.dim(1);
   int n_years = NAA.dim(2);
@@ -387,9 +384,9 @@ array<Type> get_NAA_spawn(array<Type> NAA, array<Type> annual_SAA_spawn, vector<
 
 
 template <class Type>
-vector<Type> get_pred_recruit_y(int y, vector<int> recruit_model, matrix<Type> mean_rec_pars, matrix<Type> SSB, array<Type> NAA, 
-  matrix<Type> log_SR_a, matrix<Type> log_SR_b, matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, vector<int> NAA_re_model){
+vector<Type> get_pred_recruit_y(int y, const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, const matrix<Type>& SSB, array<Type>& NAA, 
+  const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, const vector<int>& NAA_re_model){
   /*
     provide "expected" recruitment (N(age 1)) for a given year
                   y: year (between 1 and n_years_model+n_years_proj)
@@ -432,9 +429,9 @@ vector<Type> get_pred_recruit_y(int y, vector<int> recruit_model, matrix<Type> m
 }
 
 template <class Type>
-vector<Type> get_pred_recruit_y(int y, vector<int> recruit_model, matrix<Type> mean_rec_pars, vector<Type> SSB_y_minus_1, 
-  array<Type> NAA_y_minus_1, matrix<Type> log_SR_a, matrix<Type> log_SR_b, matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, vector<int> NAA_re_model){
+vector<Type> get_pred_recruit_y(int y, const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, const vector<Type>& SSB_y_minus_1, 
+  array<Type>& NAA_y_minus_1, const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, const vector<int>& NAA_re_model){
   /*
     provide "expected" recruitment (N(age 1)) for a given year
                   y: year (between 1 and n_years_model+n_years_proj)
@@ -476,7 +473,7 @@ vector<Type> get_pred_recruit_y(int y, vector<int> recruit_model, matrix<Type> m
 }
 
 template <class Type>
-array<Type> get_pred_N1(vector<int> N1_model, array<Type> N1, array<int> NAA_where, array<Type> N1_repars){
+array<Type> get_pred_N1(const vector<int>& N1_model, array<Type>& N1, array<int>& NAA_where, array<Type>& N1_repars){
   /*
     provide the "expected" numbers at age in the first year. different from N1 only if N1 are random effects.
      N1_model: 0: just age-specific numbers at age, 1: 2 pars: log_N_{1,1}, log_F0, age-structure defined by equilibrium NAA calculations, 2: AR1 random effect
@@ -503,10 +500,10 @@ array<Type> get_pred_N1(vector<int> N1_model, array<Type> N1, array<int> NAA_whe
 }
 
 template <class Type>
-array<Type> get_pred_NAA_y(int y, vector<int> N1_model, array<Type> N1, array<Type> N1_repars, array<int> NAA_where, vector<int> recruit_model, 
-  matrix<Type> mean_rec_pars, matrix<Type> SSB, array<Type> NAA, 
-  matrix<Type> log_SR_a, matrix<Type> log_SR_b, matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, array<Type> Ps, vector<int> NAA_re_model){
+array<Type> get_pred_NAA_y(int y, const vector<int>& N1_model, array<Type>& N1, array<Type>& N1_repars, array<int>& NAA_where, const vector<int>& recruit_model, 
+  const matrix<Type>& mean_rec_pars, const matrix<Type>& SSB, array<Type>& NAA, 
+  const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, array<Type>& Ps, const vector<int>& NAA_re_model){
 
   /*
     provide "expected" numbers at age given NAA from previous time step (RECRUITMENT: ONLY FOR STOCKS with RE on NAA)
@@ -555,10 +552,10 @@ array<Type> get_pred_NAA_y(int y, vector<int> N1_model, array<Type> N1, array<Ty
 }
 
 template <class Type>
-array<Type> get_pred_NAA_y(int y, vector<int> N1_model, array<Type> N1, array<Type> N1_repars, array<int> NAA_where, vector<int> recruit_model, 
-  matrix<Type> mean_rec_pars, vector<Type> SSB_y_minus_1, array<Type> NAA_y_minus_1, 
-  matrix<Type> log_SR_a, matrix<Type> log_SR_b, matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, array<Type> Ps, vector<int> NAA_re_model){
+array<Type> get_pred_NAA_y(int y, const vector<int>& N1_model, array<Type>& N1, array<Type>& N1_repars, array<int>& NAA_where, const vector<int>& recruit_model, 
+  const matrix<Type>& mean_rec_pars, const vector<Type>& SSB_y_minus_1, array<Type>& NAA_y_minus_1, 
+  const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, array<Type>& Ps, const vector<int>& NAA_re_model){
 
   /*
     provide "expected" numbers at age given NAA from previous time step (RECRUITMENT: ONLY FOR STOCKS with RE on NAA)
@@ -606,10 +603,10 @@ array<Type> get_pred_NAA_y(int y, vector<int> N1_model, array<Type> N1, array<Ty
 }
 
 template <class Type>
-array<Type> get_pred_NAA(int N1_model, array<Type> N1, array<Type> N1_repars, array<int> NAA_where, vector<int> recruit_model, 
-  matrix<Type> mean_rec_pars, matrix<Type> SSB, array<Type> NAA, 
-  matrix<Type> log_SR_a, matrix<Type> log_SR_b, matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, array<Type> annual_Ps, int n_years_model, vector<int> NAA_re_model, matrix<Type> logR_proj){
+array<Type> get_pred_NAA(int N1_model, array<Type>& N1, array<Type>& N1_repars, array<int>& NAA_where, const vector<int>& recruit_model, 
+  const matrix<Type>& mean_rec_pars, const matrix<Type>& SSB, array<Type>& NAA, 
+  const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, array<Type>& annual_Ps, int n_years_model, const vector<int>& NAA_re_model, const matrix<Type>& logR_proj){
 
   /*
     provide "expected" numbers at age given NAA from previous time step
@@ -654,13 +651,13 @@ array<Type> get_pred_NAA(int N1_model, array<Type> N1, array<Type> N1_repars, ar
 }
 
 template <class Type>
-array<Type> get_all_NAA(vector<int> NAA_re_model, vector<int> N1_model, array<Type> N1, array<Type> N1_repars, 
-  array<Type> log_NAA, array<int> NAA_where, 
-  array<Type> mature, array<Type> waa_ssb,
-  vector<int> recruit_model, matrix<Type> mean_rec_pars, matrix<Type> log_SR_a, matrix<Type> log_SR_b, 
-  matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, array<Type> annual_Ps, array<Type> annual_SAA_spawn, int n_years_model, int trace, 
-  int move_dyn){
+array<Type> get_all_NAA(const vector<int>& NAA_re_model, const vector<int>& N1_model, array<Type>& N1, array<Type>& N1_repars, 
+  array<Type>& log_NAA, array<int>& NAA_where, 
+  array<Type>& mature, array<Type>& waa_ssb,
+  const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, 
+  const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, array<Type>& annual_Ps, array<Type>& annual_SAA_spawn, int n_years_model, int trace, 
+  int move_dyn, int deterministic = 0){
   /* 
     fill out numbers at age and "expected" numbers at age
             NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
@@ -682,6 +679,8 @@ array<Type> get_all_NAA(vector<int> NAA_re_model, vector<int> N1_model, array<Ty
       annual_Ps:
       annual_SAA_spawn:
       n_years_model: 
+      deterministic: 1: realized NAA with random effects are set to the expected NAA (deterministic path used by get_NAA_screen_nll 
+        and to warm-start log_NAA)
   */
   int n_stocks = log_NAA.dim(0);
   int n_regions = log_NAA.dim(1);
@@ -745,12 +744,14 @@ array<Type> get_all_NAA(vector<int> NAA_re_model, vector<int> N1_model, array<Ty
       if(NAA_re_model(s) == 2){ //rec+1
         for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++) if(NAA_where(s,r,a)){
           NAA(0,s,r,y,a) = exp(log_NAA(s,r,y-1,a)); //year y realized. rec+1
+          if(deterministic == 1) NAA(0,s,r,y,a) = pred_NAA_y(s,r,a);
         }
       }
     if(trace) see("0.2");
       if(NAA_re_model(s) < 2) { //rec, Need to populate other ages with pred_NAA.
         //age 1 year y realized. rec
         NAA(0,s,spawn_regions(s)-1,y,0) = exp(log_NAA(s,spawn_regions(s)-1,y-1,0));
+        if((NAA_re_model(s) == 1) & (deterministic == 1)) NAA(0,s,spawn_regions(s)-1,y,0) = pred_NAA_y(s,spawn_regions(s)-1,0);
         //age 1 year y realized. SCAA
         //age 2+ year y realized. SCAA or rec
         for(int a = 1; a < n_ages; a++) for(int r = 0; r < n_regions; r++) if(NAA_where(s,r,a)){
@@ -775,19 +776,19 @@ array<Type> get_all_NAA(vector<int> NAA_re_model, vector<int> N1_model, array<Ty
 }
 
 template <class Type>
-array<Type> update_all_NAA(int y, array<Type> all_NAA, vector<int> NAA_re_model, vector<int> N1_model, array<Type> N1, array<Type> N1_repars, 
-  array<Type> log_NAA, array<int> NAA_where, 
-  array<Type> mature, array<Type> waa_ssb,
-  vector<int> recruit_model, matrix<Type> mean_rec_pars, matrix<Type> log_SR_a, matrix<Type> log_SR_b, 
-  matrix<int> Ecov_how_R, array<Type> Ecov_lm_R, 
-  vector<int> spawn_regions, array<Type> annual_Ps, array<Type> annual_SAA_spawn, int n_years_model, matrix<Type> logR_proj, int proj_R_opt, matrix<Type> R_XSPR, 
+void update_all_NAA(int y, array<Type>& all_NAA, const vector<int>& NAA_re_model, const vector<int>& N1_model, array<Type>& N1, array<Type>& N1_repars, 
+  array<Type>& log_NAA, array<int>& NAA_where, 
+  array<Type>& mature, array<Type>& waa_ssb,
+  const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, const matrix<Type>& log_SR_a, const matrix<Type>& log_SR_b, 
+  const matrix<int>& Ecov_how_R, array<Type>& Ecov_lm_R, 
+  const vector<int>& spawn_regions, array<Type>& annual_Ps, array<Type>& annual_SAA_spawn, int n_years_model, const matrix<Type>& logR_proj, int proj_R_opt, const matrix<Type>& R_XSPR, 
   int bias_correct_pe, 
-  array<Type> marg_NAA_sigma, 
-  // array<Type> log_NAA_sigma, 
+  array<Type>& marg_NAA_sigma, 
+  // array<Type>& log_NAA_sigma, 
   int trace,
   int move_dyn){ 
   /* 
-    fill out numbers at age and "expected" numbers at age for year y (intended for projection years)
+    fill out numbers at age and "expected" numbers at age for year y of all_NAA in place (intended for projection years)
             NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
              N1_model: 0: just age-specific numbers at age, 1: 2 pars: log_N_{1,1}, log_F0, age-structure defined by equilibrium NAA calculations, 2: AR1 random effect
                N1: (n_stocks x n_regions x n_ages) numbers at age in the first year
@@ -812,8 +813,7 @@ array<Type> update_all_NAA(int y, array<Type> all_NAA, vector<int> NAA_re_model,
   int n_stocks = log_NAA.dim(0);
   int n_regions = log_NAA.dim(1);
   int n_ages = log_NAA.dim(3);
-  array<Type> updated_all_NAA = all_NAA;
-  if(trace) see(updated_all_NAA.dim);
+  if(trace) see(all_NAA.dim);
   array<Type> NAA_last(n_stocks,n_regions,n_ages);
   for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++) NAA_last(s,r,a) = all_NAA(0,s,r,y-1,a);
   if(trace) see(NAA_last);
@@ -836,37 +836,36 @@ array<Type> update_all_NAA(int y, array<Type> all_NAA, vector<int> NAA_re_model,
         if(bias_correct_pe) pred_NAA_y(s,r,a) *= exp(0.5 * pow(marg_NAA_sigma(s,r,a),2)); //take out bias correction in projections in this option
       }
     }
-    updated_all_NAA(1,s,r,y,a) = pred_NAA_y(s,r,a);
+    all_NAA(1,s,r,y,a) = pred_NAA_y(s,r,a);
   }
   if(trace) see("update_all_NAA(1)");
 
   for(int s = 0; s < n_stocks; s++) {
     if(NAA_re_model(s) == 2){ //rec+1
       for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++) if(NAA_where(s,r,a)){
-        updated_all_NAA(0,s,r,y,a) = exp(log_NAA(s,r,y-1,a)); //year y realized. rec+1
+        all_NAA(0,s,r,y,a) = exp(log_NAA(s,r,y-1,a)); //year y realized. rec+1
       }
     if(trace) see("NAA_re_model == 2, update_all_NAA(0)");
     }
     if(NAA_re_model(s) < 2) { //rec, Need to populate other ages with pred_NAA.
       //age 1 year y realized. rec
       if(NAA_re_model(s) == 1) { // projected recruitment is continued RE
-        updated_all_NAA(0,s,spawn_regions(s)-1,y,0) = exp(log_NAA(s,spawn_regions(s)-1,y-1,0));
+        all_NAA(0,s,spawn_regions(s)-1,y,0) = exp(log_NAA(s,spawn_regions(s)-1,y-1,0));
       } else { //SCAA
         //age 1 year y realized. SCAA
-        updated_all_NAA(0,s,spawn_regions(s)-1,y,0) = exp(logR_proj(y-n_years_model,s));
+        all_NAA(0,s,spawn_regions(s)-1,y,0) = exp(logR_proj(y-n_years_model,s));
       }
       //for SCAA or rec, age 2+ year y realized is deterministic
       for(int a = 1; a < n_ages; a++) for(int r = 0; r < n_regions; r++) if(NAA_where(s,r,a)){
-        updated_all_NAA(0,s,r,y,a) = pred_NAA_y(s,r,a);
+        all_NAA(0,s,r,y,a) = pred_NAA_y(s,r,a);
       }
     if(trace) see("NAA_re_model < 2, update_all_NAA(0)");
     }
   }
-  return updated_all_NAA;
 }
 
 template <class Type>
-array<Type> extract_NAA(array<Type> all_NAA){
+array<Type> extract_NAA(array<Type>& all_NAA){
   int n_stocks = all_NAA.dim(1);
   int n_regions = all_NAA.dim(2);
   int n_y = all_NAA.dim(3); 
@@ -880,7 +879,7 @@ array<Type> extract_NAA(array<Type> all_NAA){
 }
 
 template <class Type>
-array<Type> extract_pred_NAA(array<Type> all_NAA){
+array<Type> extract_pred_NAA(array<Type>& all_NAA){
   int n_stocks = all_NAA.dim(1);
   int n_regions = all_NAA.dim(2);
   int n_y = all_NAA.dim(3); 
@@ -895,7 +894,7 @@ array<Type> extract_pred_NAA(array<Type> all_NAA){
 
 
 template <class Type>
-array<Type> get_NAA_devs(array<Type> all_NAA, array<int> NAA_where, vector<int> NAA_re_model){
+array<Type> get_NAA_devs(array<Type>& all_NAA, array<int>& NAA_where, const vector<int>& NAA_re_model){
   int n_stocks = all_NAA.dim(1);
   int n_regions = all_NAA.dim(2);
   int n_y = all_NAA.dim(3); 
@@ -924,7 +923,7 @@ array<Type> get_NAA_devs(array<Type> all_NAA, array<int> NAA_where, vector<int>
 }
 
 template <class Type>
-array<Type> get_NAA_y(int y, array<Type> NAA){
+array<Type> get_NAA_y(int y, array<Type>& NAA){
   int n_stocks = NAA.dim(0);
   int n_regions = NAA.dim(1);
   int n_ages = NAA.dim(3);
@@ -937,7 +936,7 @@ array<Type> get_NAA_y(int y, array<Type> NAA){
 }
 
 template <class Type>
-array<Type> get_log_NAA_rep(array<Type> NAA, array<int> NAA_where){
+array<Type> get_log_NAA_rep(array<Type>& NAA, array<int>& NAA_where){
   array<Type> log_NAA = NAA;
   log_NAA.setZero();
   for(int s = 0; s < NAA.dim(0); s++) for(int r = 0; r < NAA.dim(1); r++) for(int y = 0; y < NAA.dim(2); y++) for(int a = 0; a < NAA.dim(3); a++){
@@ -950,7 +949,7 @@ array<Type> get_log_NAA_rep(array<Type> NAA, array<int> NAA_where){
 }
 
 template <class Type>
-matrix<Type> get_SR_log_a(vector<int> recruit_model, matrix<Type> mean_rec_pars, array<Type> Ecov_lm_R, matrix<int> Ecov_how_R){
+matrix<Type> get_SR_log_a(const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, array<Type>& Ecov_lm_R, const matrix<int>& Ecov_how_R){
   /*
     make annual stock recruit log(a) parameters for each stock
       recruit_model: n_stocks; which recruitment model; 3=BH, 4=Ricker
@@ -988,7 +987,7 @@ matrix<Type> get_SR_log_a(vector<int> recruit_model, matrix<Type> mean_rec_pars,
 }
 
 template <class Type>
-matrix<Type> get_SR_log_b(vector<int> recruit_model, matrix<Type> mean_rec_pars, array<Type> Ecov_lm_R, matrix<int> Ecov_how_R){
+matrix<Type> get_SR_log_b(const vector<int>& recruit_model, const matrix<Type>& mean_rec_pars, array<Type>& Ecov_lm_R, const matrix<int>& Ecov_how_R){
   /*
     make annual stock recruit log(b) parameters for each stock
       recruit_model: n_stocks; which recruitment model; 3=BH, 4=Ricker
@@ -1028,10 +1027,10 @@ matrix<Type> get_SR_log_b(vector<int> recruit_model, matrix<Type> mean_rec_pars,
 }
 
 template <class Type>
-array<Type> get_NAA_index(array<Type> NAA, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, 
-  vector<Type> fracyr_seasons,
-  matrix<Type> fracyr_indices, vector<int> index_seasons, vector<int> index_regions, array<Type> FAA, array<Type> log_M, 
-  array<Type> mu, matrix<Type> L, int n_years_model){
+array<Type> get_NAA_index(array<Type>& NAA, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, 
+  const vector<Type>& fracyr_seasons,
+  const matrix<Type>& fracyr_indices, const vector<int>& index_seasons, const vector<int>& index_regions, array<Type>& FAA, array<Type>& log_M, 
+  array<Type>& mu, const matrix<Type>& L, int n_years_model){
   /*
     produce the annual survival probabilities up to time of spawning for a given stock, age, season, year
                 NAA: nstocks x nregions x nyears x nages; array of numbers at age 
@@ -1083,8 +1082,8 @@ array<Type> get_NAA_index(array<Type> NAA, vector<int> fleet_regions, matrix<int
 }
 
 template <class Type>
-array<Type> get_NAA_catch(array<Type> NAA, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, 
-  vector<Type> fracyr_seasons, array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+array<Type> get_NAA_catch(array<Type>& NAA, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, 
+  const vector<Type>& fracyr_seasons, array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the numbers caught by stock, fleet, year, season, age up to time of spawning for a given stock, age, season, year
                 NAA: nstocks x nregions x nyears x nages; array of numbers at age 
@@ -1145,203 +1144,229 @@ array<Type> get_NAA_catch(array<Type> NAA, vector<int> fleet_regions, matrix<int
 template <class Type>
 matrix<Type> get_NAA_nll(vector<int> NAA_re_model, array<Type> all_NAA, array<Type> log_NAA_sigma, array<Type> trans_NAA_rho, 
   array<int> NAA_where,
-  vector<int> spawn_regions, vector<int> years_use, int bias_correct_pe, int decouple_recruitment = 0, int use_alt_AR1 = 0){
+  vector<int> spawn_regions, vector<int> years_use, array<int> NAA_cor_units, vector<Type> NAA_units_cor, vector<int> NAA_rec_cor_units, 
+  vector<Type> NAA_rec_units_cor, int bias_correct_pe, int decouple_recruitment = 0, int use_alt_AR1 = 0){
   /*
             NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
   */
-  //currently independent 2D (at most) AR1 processes by stock and region. not all ages may be available in all regions. number of stocks will typically be small
+  //independent 2D (at most) AR1 processes by stock and region unless units are joined by NAA_cor_units/NAA_rec_cor_units. 
+  //not all ages may be available in all regions. number of stocks will typically be small
   //NAA_logsigma n_stocks x n_ages x n_regions
   //trans_NAA_rho n_stocks x n_regions x 3 (rho_a, rho_y, recruits rho_y) 
+  //NAA_cor_units n_stocks x n_regions: 0 = independent, otherwise unit (1,...,n_u) of a 3D separable GMRF (age x year x unit) for "rec+1" deviations
+  //  with unstructured correlation across units (NAA_units_cor). rho_a and rho_y of unit 1 are used for all units.
+  //NAA_rec_cor_units n_stocks: same for recruitment deviations modeled separately ("rec" or decoupled), 2D GMRF (year x stock), NAA_rec_units_cor.
+  //the nll of a joint GMRF is stored in the element of nll_NAA for unit 1.
   //years_use is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
+  //densities are from ar1_re.hpp
 
-  // array<Type> all_NAA = get_all_NAA(NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
-  //   mature, waa_ssb, recruit_model, mean_rec_pars, log_SR_a, log_SR_b, 
-  //   Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model,0); //log_NAA should be mapped accordingly to exclude NAA=0 e.g., recruitment by region.
   array<Type> NAA = extract_NAA(all_NAA);
   array<Type> pred_NAA = extract_pred_NAA(all_NAA);
 
   int n_stocks = NAA.dim(0);
   int n_years = years_use.size();
-  //int n_years = NAA.dim(2);
   int n_ages = NAA.dim(3);
   int n_regions = NAA.dim(1);
   int rho_y_ind = 1;
   if(decouple_recruitment) rho_y_ind = 2;
+  int age_start = 0;
+  if(decouple_recruitment) age_start = 1;
 
-  vector<Type> marginal_sigma(n_ages); //sigmas for one stock
   Type NAA_rho_a = 0, NAA_rho_y = 0;
   matrix<Type> nll_NAA(n_stocks,n_regions);
   nll_NAA.setZero();
-  //can we do vector< vector< matrix<Type>>>?
+  matrix<Type> Q_1(1,1); //precision across units when there is just one unit
+  Q_1.setIdentity();
   //NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
   for(int s = 0; s < n_stocks; s++) if(NAA_re_model(s)>0){
-    marginal_sigma.setZero(); //clear for each stock
-    if((NAA_re_model(s) == 1) | ((NAA_re_model(s) == 2) & decouple_recruitment)){ //"rec"
+    if(((NAA_re_model(s) == 1) | ((NAA_re_model(s) == 2) & decouple_recruitment)) & (NAA_rec_cor_units(s) == 0)){ //"rec"
       vector<Type> NAA_devs_r_s(n_years-1);
       // for NAA_re_model = 1, must make sure that rho_a = 0 and rho_y is set appropriately (cor = "iid" or "ar1_y") on R side
       NAA_rho_y = geninvlogit(trans_NAA_rho(s,spawn_regions(s)-1,rho_y_ind), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
-      marginal_sigma(0) = exp(log_NAA_sigma(s,spawn_regions(s)-1,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
+      Type marginal_sigma = exp(log_NAA_sigma(s,spawn_regions(s)-1,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
       for(int y = 1; y < n_years; y++) NAA_devs_r_s(y-1) = log(NAA(s,spawn_regions(s)-1,years_use(y),0)) - log(pred_NAA(s,spawn_regions(s)-1,years_use(y),0));
-      if(bias_correct_pe) NAA_devs_r_s += 0.5*pow(marginal_sigma(0),2); //make sure this is ok when just recruitment is random.
       if(use_alt_AR1==0){
-        nll_NAA(s,spawn_regions(s)-1) += SCALE(AR1(NAA_rho_y), marginal_sigma(0))(NAA_devs_r_s);
+        nll_NAA(s,spawn_regions(s)-1) += dar1_re(NAA_devs_r_s, NAA_rho_y, marginal_sigma, bias_correct_pe);
       } else {
+        if(bias_correct_pe) NAA_devs_r_s += 0.5*pow(marginal_sigma,2);
         nll_NAA(s,spawn_regions(s)-1) +=  dar1(NAA_devs_r_s, trans_NAA_rho(s,spawn_regions(s)-1,rho_y_ind), log_NAA_sigma(s,spawn_regions(s)-1,0), 0);
       }
     }
     if(NAA_re_model(s) == 2){ //"rec+1"
-      for(int r = 0; r < n_regions; r++){
-
-        // for NAA_re_model = 1, must make sure that rho_a = 0 and rho_y is set appropriately (cor = "iid" or "ar1_y") on R side
+      for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r) == 0) {
         NAA_rho_a = geninvlogit(trans_NAA_rho(s,r,0), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
         NAA_rho_y = geninvlogit(trans_NAA_rho(s,r,1), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
         int n_age_s_r = 0;
-        int age_start = 0;
-        if(decouple_recruitment) age_start = 1;
         for(int a = age_start; a< n_ages; a++) {
           if(NAA_where(s,r,a)) n_age_s_r++; //start after recruitment when decouple_recruitment= 1
         }
         if(n_age_s_r>0) {// has to be some fish of some age in this region
-          array<Type> NAA_devs_s_r(n_years-1, n_age_s_r);
-          NAA_devs_s_r.setZero();
+          matrix<Type> NAA_devs_s_r(n_years-1, n_age_s_r);
           vector<Type> marginal_sigma_s_r(n_age_s_r), log_sigma_s_r(n_age_s_r);
+          matrix<int> use_a(1, n_ages-age_start); //ages present in this region
           int k=0;
-          for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
-            log_sigma_s_r(k) = log_NAA_sigma(s,r,a);
-            marginal_sigma_s_r(k) = exp(log_sigma_s_r(k)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
-            k++;
+          for(int a = age_start; a< n_ages; a++) {
+            use_a(0,a-age_start) = NAA_where(s,r,a);
+            if(NAA_where(s,r,a)) {
+              log_sigma_s_r(k) = log_NAA_sigma(s,r,a);
+              marginal_sigma_s_r(k) = exp(log_sigma_s_r(k)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
+              k++;
+            }
           }
           for(int y = 1; y < n_years; y++) {
             k=0;
             for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
               NAA_devs_s_r(y-1,k) = log(NAA(s,r,years_use(y),a)) - log(pred_NAA(s,r,years_use(y),a));
-              if(bias_correct_pe) NAA_devs_s_r(y-1,k) += 0.5*pow(marginal_sigma_s_r(k),2);
               k++;
             }
           }
-          // see(NAA_devs_s_r);
-          // see(NAA_devs_s_r.rows());
-          // see(NAA_devs_s_r.cols());
-          // see(marginal_sigma_s_r);
-          // see(NAA_rho_a);
-          // see(NAA_rho_y);
           if(use_alt_AR1==0){
-            nll_NAA(s,r) += SEPARABLE(VECSCALE(AR1(NAA_rho_a), marginal_sigma_s_r),AR1(NAA_rho_y))(NAA_devs_s_r);
+            //separable GMRF conditional on ages not present (the AR1 neighbours are not changed by missing ages)
+            nll_NAA(s,r) += d3dar1_re(NAA_devs_s_r, NAA_rho_y, NAA_rho_a, Q_1, use_a, marginal_sigma_s_r, bias_correct_pe);
           } else {
-            see("using alt2dar1");
-            nll_NAA(s,r) += d2dar1(NAA_devs_s_r, trans_NAA_rho(s,r,1), trans_NAA_rho(s,r,0), log_sigma_s_r, 0);
+            array<Type> NAA_devs_alt(n_years-1, n_age_s_r);
+            for(int y = 0; y < n_years-1; y++) for(int j = 0; j < n_age_s_r; j++) {
+              NAA_devs_alt(y,j) = NAA_devs_s_r(y,j);
+              if(bias_correct_pe) NAA_devs_alt(y,j) += 0.5*pow(marginal_sigma_s_r(j),2);
+            }
+            nll_NAA(s,r) += d2dar1(NAA_devs_alt, trans_NAA_rho(s,r,1), trans_NAA_rho(s,r,0), log_sigma_s_r, 0);
           }
-          // see(nll_NAA(s,r));
-          //std::exit(EXIT_FAILURE);
         }
       }
     }
   }
+  
+  int n_u = 0, n_u_R = 0;
+  for(int s = 0; s < n_stocks; s++) {
+    if(NAA_rec_cor_units(s) > n_u_R) n_u_R = NAA_rec_cor_units(s);
+    for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r) > n_u) n_u = NAA_cor_units(s,r);
+  }
+  //joint GMRF of "rec+1" deviations over (stock,region) units
+  if(n_u > 0) {
+    vector<int> unit_s(n_u), unit_r(n_u);
+    for(int s = 0; s < n_stocks; s++) for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r)) {
+      unit_s(NAA_cor_units(s,r)-1) = s;
+      unit_r(NAA_cor_units(s,r)-1) = r;
+    }
+    matrix<int> use_ua(n_u, n_ages-age_start);
+    for(int u = 0; u < n_u; u++) for(int a = age_start; a < n_ages; a++) use_ua(u,a-age_start) = NAA_where(unit_s(u),unit_r(u),a);
+    int n_c = use_ua.sum();
+    NAA_rho_a = geninvlogit(trans_NAA_rho(unit_s(0),unit_r(0),0), Type(-1), Type(1), Type(1));
+    NAA_rho_y = geninvlogit(trans_NAA_rho(unit_s(0),unit_r(0),1), Type(-1), Type(1), Type(1));
+    vector<Type> marginal_sigma_c(n_c);
+    matrix<Type> NAA_devs_c(n_years-1, n_c);
+    int k = 0;
+    for(int u = 0; u < n_u; u++) for(int a = age_start; a < n_ages; a++) if(NAA_where(unit_s(u),unit_r(u),a)) {
+      marginal_sigma_c(k) = exp(log_NAA_sigma(unit_s(u),unit_r(u),a)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
+      for(int y = 1; y < n_years; y++) {
+        NAA_devs_c(y-1,k) = log(NAA(unit_s(u),unit_r(u),years_use(y),a)) - log(pred_NAA(unit_s(u),unit_r(u),years_use(y),a));
+      }
+      k++;
+    }
+    nll_NAA(unit_s(0),unit_r(0)) += d3dar1_re(NAA_devs_c, NAA_rho_y, NAA_rho_a, get_unit_cor_Q(NAA_units_cor, n_u), use_ua, 
+      marginal_sigma_c, bias_correct_pe);
+  }
+  //joint GMRF of recruitment deviations over stocks
+  if(n_u_R > 0) {
+    vector<int> unit_s(n_u_R);
+    for(int s = 0; s < n_stocks; s++) if(NAA_rec_cor_units(s)) unit_s(NAA_rec_cor_units(s)-1) = s;
+    matrix<int> use_u(n_u_R, 1);
+    use_u.fill(1);
+    NAA_rho_y = geninvlogit(trans_NAA_rho(unit_s(0),spawn_regions(unit_s(0))-1,rho_y_ind), Type(-1), Type(1), Type(1));
+    vector<Type> marginal_sigma_c(n_u_R);
+    matrix<Type> NAA_devs_c(n_years-1, n_u_R);
+    for(int u = 0; u < n_u_R; u++) {
+      int s = unit_s(u), r = spawn_regions(s)-1;
+      marginal_sigma_c(u) = exp(log_NAA_sigma(s,r,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
+      for(int y = 1; y < n_years; y++) NAA_devs_c(y-1,u) = log(NAA(s,r,years_use(y),0)) - log(pred_NAA(s,r,years_use(y),0));
+    }
+    nll_NAA(unit_s(0),spawn_regions(unit_s(0))-1) += d3dar1_re(NAA_devs_c, NAA_rho_y, Type(0), get_unit_cor_Q(NAA_rec_units_cor, n_u_R), use_u, 
+      marginal_sigma_c, bias_correct_pe);
+  }
   return nll_NAA;
 }
 
 template <class Type>
 array<Type> simulate_NAA_devs(array<Type> NAA_devs, vector<int> NAA_re_model, array<Type> log_NAA_sigma, array<Type> trans_NAA_rho, array<int> NAA_where, 
-  vector<int> spawn_regions, vector<int> years_use, int bias_correct_pe, int decouple_recruitment = 0, int use_alt_AR1 = 0, int ystart = 0){
+  vector<int> spawn_regions, vector<int> years_use, array<int> NAA_cor_units, vector<Type> NAA_units_cor, vector<int> NAA_rec_cor_units, 
+  vector<Type> NAA_rec_units_cor, int bias_correct_pe, int decouple_recruitment = 0, int use_alt_AR1 = 0, int ystart = 0){
   /*
             NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
   */
   //simulate NAA devs for all model and projection years. The predicted NAA in projection years can change and simulate_log_NAA will change in projection years
-  //currently independent 2D (at most) AR1 processes by stock and region. not all ages may be available in all regions. number of stocks will typically be small
+  //independent 2D (at most) AR1 processes by stock and region unless units are joined by NAA_cor_units/NAA_rec_cor_units (see get_NAA_nll). 
+  //not all ages may be available in all regions. number of stocks will typically be small
   //NAA_logsigma n_stocks x n_ages x n_regions
   //trans_NAA_rho n_stocks x n_regions x 3 (rho_a, rho_y, recruit rho_y) 
   //years_use is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
+  //years before ystart are kept and later years are simulated conditional on them.
 
   int n_stocks = NAA_devs.dim(0);
-  //int n_years_sim = years_use.size()-1;
   int n_years = years_use.size();
-  //int n_years_pop = NAA_devs.dim(2); //all years
   int n_ages = NAA_devs.dim(3);
   int n_regions = NAA_devs.dim(1);
   Type NAA_rho_y = 0, NAA_rho_a = 0;
   array<Type> NAA_devs_out = NAA_devs; //(n_stocks, n_regions, n_years_pop, n_ages); //same dims as that provided by get_NAA_devs
-  vector<Type> marginal_sigma(n_ages);
 
   int rho_y_ind = 1;
   if(decouple_recruitment) rho_y_ind = 2;
+  int age_start = 0;
+  if(decouple_recruitment) age_start = 1;
+  matrix<Type> Q_1(1,1); //precision across units when there is just one unit
+  Q_1.setIdentity();
 
   //NAA_re_model: 0 SCAA, 1 "rec", 2 "rec+1"
   for(int s = 0; s < n_stocks; s++) if(NAA_re_model(s)>0){
-    marginal_sigma.setZero();  //clear for each stock
-    if((NAA_re_model(s) == 1) | ((NAA_re_model(s) == 2) & decouple_recruitment)){ //"rec"
-      // see(decouple_recruitment);
-      // see(NAA_re_model(s));
+    if(((NAA_re_model(s) == 1) | ((NAA_re_model(s) == 2) & decouple_recruitment)) & (NAA_rec_cor_units(s) == 0)){ //"rec"
       // for NAA_re_model = 1, must make sure that rho_a = 0 and rho_y is set appropriately (cor = "iid" or "ar1_y") on R side
       NAA_rho_y = geninvlogit(trans_NAA_rho(s,spawn_regions(s)-1,rho_y_ind), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
-      marginal_sigma(0) = exp(log_NAA_sigma(s,spawn_regions(s)-1,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
+      Type marginal_sigma = exp(log_NAA_sigma(s,spawn_regions(s)-1,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
       vector<Type> NAA_devs_r_s(n_years-1);
-      NAA_devs_r_s.setZero();
+      for(int y = 1; y < n_years; y++) NAA_devs_r_s(y-1) = NAA_devs_out(s,spawn_regions(s)-1,years_use(y),0);
       if(use_alt_AR1==1){ //do simulation using conditional pdfs
-        for(int y = 1; y < n_years; y++){
-          NAA_devs_r_s(y-1) = NAA_devs_out(s,spawn_regions(s)-1,years_use(y),0);
-        }
         NAA_devs_r_s = rar1(NAA_devs_r_s,trans_NAA_rho(s,spawn_regions(s)-1,rho_y_ind),log_NAA_sigma(s,spawn_regions(s)-1,0),0,ystart,bias_correct_pe);
       } else{
-        AR1(NAA_rho_y).simulate(NAA_devs_r_s); // sigma = 1, scale below
-        NAA_devs_r_s = marginal_sigma(0) * NAA_devs_r_s;
-        if(bias_correct_pe) NAA_devs_r_s -= 0.5*pow(marginal_sigma(0),2);
+        NAA_devs_r_s = rar1_re(NAA_devs_r_s, NAA_rho_y, marginal_sigma, ystart, bias_correct_pe);
       }
       for(int y = ystart+1; y < n_years; y++){
         NAA_devs_out(s,spawn_regions(s)-1,years_use(y),0) = NAA_devs_r_s(y-1);
       }
     }
     if(NAA_re_model(s) == 2){ //"rec+1"
-      for(int r = 0; r < n_regions; r++){
+      for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r) == 0) {
         NAA_rho_a = geninvlogit(trans_NAA_rho(s,r,0), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
         NAA_rho_y = geninvlogit(trans_NAA_rho(s,r,1), Type(-1), Type(1), Type(1)); //using scale =1 ,2 is legacy
         int n_age_s_r = 0;
-        int age_start = 0;
-        if(decouple_recruitment) age_start = 1;
         for(int a = age_start; a< n_ages; a++) {
           if(NAA_where(s,r,a)) n_age_s_r++; //start after recruitment when decouple_recruitment= 1
         }
         if(n_age_s_r>0) {// has to be some fish of some age in this region
-          array<Type> NAA_devs_s_r(n_years-1, n_age_s_r);
-          NAA_devs_s_r.setZero();
+          matrix<Type> NAA_devs_s_r(n_years-1, n_age_s_r);
           vector<Type> marginal_sigma_s_r(n_age_s_r), log_sigma_s_r(n_age_s_r);
+          matrix<int> use_a(1, n_ages-age_start); //ages present in this region
           int k=0;
-          for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
-            log_sigma_s_r(k) = log_NAA_sigma(s,r,a);
-            marginal_sigma_s_r(k) = exp(log_sigma_s_r(k)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
-            k++;
+          for(int a = age_start; a< n_ages; a++) {
+            use_a(0,a-age_start) = NAA_where(s,r,a);
+            if(NAA_where(s,r,a)) {
+              log_sigma_s_r(k) = log_NAA_sigma(s,r,a);
+              marginal_sigma_s_r(k) = exp(log_sigma_s_r(k)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
+              for(int y = 1; y < n_years; y++) NAA_devs_s_r(y-1,k) = NAA_devs_out(s,r,years_use(y),a);
+              k++;
+            }
           }
-          // see(use_alt_AR1);
-          // see(ystart);
-          // see(age_start);
           if(use_alt_AR1==1){ //do simulation using conditional pdfs
-            for(int y = ystart+1; y < n_years; y++) {
-              k=0;
-              for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
-                // if(a == 0) see(NAA_devs_out(s,r,years_use(y),a));
-                NAA_devs_s_r(y-1,k) = NAA_devs_out(s,r,years_use(y),a);
-                k++;
-              }
-              NAA_devs_s_r = r2dar1(NAA_devs_s_r,trans_NAA_rho(s,r,1), trans_NAA_rho(s,r,0), log_sigma_s_r,0,ystart,bias_correct_pe);
-            }
+            array<Type> NAA_devs_alt(n_years-1, n_age_s_r);
+            for(int y = 0; y < n_years-1; y++) for(int j = 0; j < n_age_s_r; j++) NAA_devs_alt(y,j) = NAA_devs_s_r(y,j);
+            NAA_devs_alt = r2dar1(NAA_devs_alt,trans_NAA_rho(s,r,1), trans_NAA_rho(s,r,0), log_sigma_s_r,0,ystart,bias_correct_pe);
+            for(int y = 0; y < n_years-1; y++) for(int j = 0; j < n_age_s_r; j++) NAA_devs_s_r(y,j) = NAA_devs_alt(y,j);
           } else {
-            SEPARABLE(VECSCALE(AR1(NAA_rho_a), marginal_sigma_s_r),AR1(NAA_rho_y)).simulate(NAA_devs_s_r); // scaled here
-            for(int y = ystart+1; y < n_years; y++) { 
-              k=0;
-              for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
-                if(bias_correct_pe) NAA_devs_s_r(y-1,k) -= 0.5*pow(marginal_sigma_s_r(k),2);
-                k++;
-              }
-            }
+            //same conditional (on ages not present) GMRF as get_NAA_nll
+            NAA_devs_s_r = r3dar1_re(NAA_devs_s_r, NAA_rho_y, NAA_rho_a, Q_1, use_a, marginal_sigma_s_r, ystart, bias_correct_pe);
           }
           for(int y = ystart+1; y < n_years; y++) { 
             k=0;
             for(int a = age_start; a< n_ages; a++) if(NAA_where(s,r,a)) {
-              // if(a == 0) see(years_use(y));
-              // if(a == 0) see(NAA_devs_out(s,r,years_use(y),a));
               NAA_devs_out(s,r,years_use(y),a) = NAA_devs_s_r(y-1,k);
-              // if(a == 0) see(NAA_devs_out(s,r,years_use(y),a));
               k++;
             }
           }
@@ -1349,6 +1374,60 @@ array<Type> simulate_NAA_devs(array<Type> NAA_devs, vector<int> NAA_re_model, ar
       }
     }
   }
+
+  int n_u = 0, n_u_R = 0;
+  for(int s = 0; s < n_stocks; s++) {
+    if(NAA_rec_cor_units(s) > n_u_R) n_u_R = NAA_rec_cor_units(s);
+    for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r) > n_u) n_u = NAA_cor_units(s,r);
+  }
+  //joint GMRF of "rec+1" deviations over (stock,region) units
+  if(n_u > 0) {
+    vector<int> unit_s(n_u), unit_r(n_u);
+    for(int s = 0; s < n_stocks; s++) for(int r = 0; r < n_regions; r++) if(NAA_cor_units(s,r)) {
+      unit_s(NAA_cor_units(s,r)-1) = s;
+      unit_r(NAA_cor_units(s,r)-1) = r;
+    }
+    matrix<int> use_ua(n_u, n_ages-age_start);
+    for(int u = 0; u < n_u; u++) for(int a = age_start; a < n_ages; a++) use_ua(u,a-age_start) = NAA_where(unit_s(u),unit_r(u),a);
+    int n_c = use_ua.sum();
+    NAA_rho_a = geninvlogit(trans_NAA_rho(unit_s(0),unit_r(0),0), Type(-1), Type(1), Type(1));
+    NAA_rho_y = geninvlogit(trans_NAA_rho(unit_s(0),unit_r(0),1), Type(-1), Type(1), Type(1));
+    vector<Type> marginal_sigma_c(n_c);
+    matrix<Type> NAA_devs_c(n_years-1, n_c);
+    int k = 0;
+    for(int u = 0; u < n_u; u++) for(int a = age_start; a < n_ages; a++) if(NAA_where(unit_s(u),unit_r(u),a)) {
+      marginal_sigma_c(k) = exp(log_NAA_sigma(unit_s(u),unit_r(u),a)) * pow((1-pow(NAA_rho_y,2))*(1-pow(NAA_rho_a,2)),-0.5);
+      for(int y = 1; y < n_years; y++) NAA_devs_c(y-1,k) = NAA_devs_out(unit_s(u),unit_r(u),years_use(y),a);
+      k++;
+    }
+    NAA_devs_c = r3dar1_re(NAA_devs_c, NAA_rho_y, NAA_rho_a, get_unit_cor_Q(NAA_units_cor, n_u), use_ua, marginal_sigma_c, ystart, bias_correct_pe);
+    for(int y = ystart+1; y < n_years; y++) {
+      k = 0;
+      for(int u = 0; u < n_u; u++) for(int a = age_start; a < n_ages; a++) if(NAA_where(unit_s(u),unit_r(u),a)) {
+        NAA_devs_out(unit_s(u),unit_r(u),years_use(y),a) = NAA_devs_c(y-1,k);
+        k++;
+      }
+    }
+  }
+  //joint GMRF of recruitment deviations over stocks
+  if(n_u_R > 0) {
+    vector<int> unit_s(n_u_R);
+    for(int s = 0; s < n_stocks; s++) if(NAA_rec_cor_units(s)) unit_s(NAA_rec_cor_units(s)-1) = s;
+    matrix<int> use_u(n_u_R, 1);
+    use_u.fill(1);
+    NAA_rho_y = geninvlogit(trans_NAA_rho(unit_s(0),spawn_regions(unit_s(0))-1,rho_y_ind), Type(-1), Type(1), Type(1));
+    vector<Type> marginal_sigma_c(n_u_R);
+    matrix<Type> NAA_devs_c(n_years-1, n_u_R);
+    for(int u = 0; u < n_u_R; u++) {
+      int s = unit_s(u), r = spawn_regions(s)-1;
+      marginal_sigma_c(u) = exp(log_NAA_sigma(s,r,0)) * pow(1-pow(NAA_rho_y,2),-0.5);
+      for(int y = 1; y < n_years; y++) NAA_devs_c(y-1,u) = NAA_devs_out(s,r,years_use(y),0);
+    }
+    NAA_devs_c = r3dar1_re(NAA_devs_c, NAA_rho_y, Type(0), get_unit_cor_Q(NAA_rec_units_cor, n_u_R), use_u, marginal_sigma_c, ystart, bias_correct_pe);
+    for(int u = 0; u < n_u_R; u++) for(int y = ystart+1; y < n_years; y++) {
+      NAA_devs_out(unit_s(u),spawn_regions(unit_s(u))-1,years_use(y),0) = NAA_devs_c(y-1,u);
+    }
+  }
   return NAA_devs_out;
 }
 
@@ -1406,3 +1485,87 @@ matrix<Type> get_simulated_log_NAA(vector<int> N1_model, array<Type> N1, array<T
 
   return sim_log_NAA;
 }
+
+template <class Type>
+Type get_NAA_screen_nll(array<Type>& NAA, array<Type>& annual_Ps, array<int>& NAA_where, array<Type>& log_NAA_sigma, array<Type>& trans_NAA_rho, 
+  array<Type>& pred_CAA, array<Type>& waa_catch, const matrix<Type>& agg_catch, const matrix<int>& use_agg_catch, const matrix<Type>& pred_log_catch, 
+  const matrix<Type>& agg_catch_sigma, const vector<Type>& log_catch_sig_scale, array<Type>& pred_IAA, const vector<int>& units_indices, array<Type>& waa, 
+  const vector<int>& waa_pointer_indices, const matrix<Type>& agg_indices, const matrix<int>& use_indices, const matrix<Type>& pred_log_indices, 
+  const matrix<Type>& agg_index_sigma, const vector<Type>& log_index_sig_scale, int n_years_model, int bias_correct_pe, int decouple_recruitment = 0){
+  /*
+    Linearized (extended Kalman filter-type) approximation of the marginal likelihood of aggregate catch and index observations for 
+    screening fits of a single stock in a single region with NAA_re_model = 1 ("rec"). Recruitment deviations are not random effects;
+    the population is projected along the deterministic path (get_all_NAA with deterministic = 1) and the log-scale predictions are linearized
+    with respect to the AR1 recruitment deviations, giving a multivariate normal likelihood for all aggregate observations jointly. 
+    The effect of deviations on SSB (and therefore on expected recruitment) is ignored. Age composition likelihoods are evaluated 
+    on the deterministic path.
+  */
+  int n_ages = NAA.dim(3);
+  int n_fleets = pred_CAA.dim(0);
+  int n_indices = pred_IAA.dim(0);
+  int n_u = n_years_model - 1; //recruitment deviations in years 2,...,n_years_model
+  int rho_y_ind = 1;
+  if(decouple_recruitment) rho_y_ind = 2;
+  Type rho = geninvlogit(trans_NAA_rho(0,0,rho_y_ind), Type(-1), Type(1), Type(1));
+  Type marg_var = exp(Type(2) * log_NAA_sigma(0,0,0))/(Type(1) - rho * rho);
+
+  //derivatives of NAA with respect to each recruitment deviation (on log scale)
+  array<Type> dNAA(n_years_model, n_ages, n_u);
+  dNAA.setZero();
+  for(int t = 0; t < n_u; t++) {
+    dNAA(t+1,0,t) = NAA(0,0,t+1,0);
+    for(int y = t+2; y < n_years_model; y++) {
+      for(int a = 1; a < n_ages; a++) dNAA(y,a,t) = annual_Ps(0,y-1,a-1,0,0) * dNAA(y-1,a-1,t);
+      dNAA(y,n_ages-1,t) += annual_Ps(0,y-1,n_ages-1,0,0) * dNAA(y-1,n_ages-1,t);
+    }
+  }
+
+  int n_obs = 0;
+  for(int y = 0; y < n_years_model; y++) {
+    for(int f = 0; f < n_fleets; f++) if(use_agg_catch(y,f)) n_obs++;
+    for(int i = 0; i < n_indices; i++) if(use_indices(y,i)) n_obs++;
+  }
+  if(n_obs == 0) return Type(0);
+  vector<Type> resid(n_obs);
+  matrix<Type> V(n_obs, n_obs);
+  matrix<Type> J(n_obs, n_u); //jacobian of log-scale predictions with respect to deviations
+  V.setZero();
+  J.setZero();
+  vector<Type> w(n_ages);
+  int k = 0;
+  for(int y = 0; y < n_years_model; y++) {
+    for(int f = 0; f < n_fleets; f++) if(use_agg_catch(y,f)) {
+      Type tot = 0;
+      for(int a = 0; a < n_ages; a++) {
+        w(a) = pred_CAA(f,y,a) * waa_catch(f,y,a);
+        tot += w(a);
+      }
+      for(int a = 0; a < n_ages; a++) if(NAA_where(0,0,a)) for(int t = 0; t < y; t++) J(k,t) += w(a) * dNAA(y,a,t)/(NAA(0,0,y,a) * tot);
+      resid(k) = log(agg_catch(y,f)) - pred_log_catch(y,f);
+      V(k,k) = pow(agg_catch_sigma(y,f) * exp(log_catch_sig_scale(f)),2);
+      k++;
+    }
+    for(int i = 0; i < n_indices; i++) if(use_indices(y,i)) {
+      Type tot = 0;
+      for(int a = 0; a < n_ages; a++) {
+        w(a) = pred_IAA(i,y,a);
+        if(units_indices(i) == 1) w(a) *= waa(waa_pointer_indices(i)-1,y,a);
+        tot += w(a);
+      }
+      for(int a = 0; a < n_ages; a++) if(NAA_where(0,0,a)) for(int t = 0; t < y; t++) J(k,t) += w(a) * dNAA(y,a,t)/(NAA(0,0,y,a) * tot);
+      resid(k) = log(agg_indices(y,i)) - pred_log_indices(y,i);
+      V(k,k) = pow(agg_index_sigma(y,i) * exp(log_index_sig_scale(i)),2);
+      k++;
+    }
+  }
+  //AR1 covariance (and mean, if bias corrected) of deviations
+  matrix<Type> Sigma(n_u, n_u);
+  for(int t = 0; t < n_u; t++) {
+    Sigma(t,t) = marg_var;
+    for(int tt = t+1; tt < n_u; tt++) Sigma(tt,t) = Sigma(t,tt) = rho * Sigma(t,tt-1);
+  }
+  if(bias_correct_pe) for(int i = 0; i < n_obs; i++) resid(i) += Type(0.5) * marg_var * J.row(i).sum();
+  V += J * Sigma * J.transpose();
+  density::MVNORM_t<Type> mvn(V);
+  return mvn(resid);
+}
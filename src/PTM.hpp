@@ -1,8 +1,8 @@
 //NOTE get_P_t_base here is defined as class T instead of Type, but is currently used interchangeably.
 // Not sure if this affects expected model performance.
 template <class T>
-matrix<T> get_P_t_base(vector<int> fleet_regions, matrix<int> can_move, int mig_type, T time, vector<T> F, vector<T> M, 
-  matrix<T> mu, vector<T> L, int trace = 0) {
+matrix<T> get_P_t_base(const vector<int>& fleet_regions, const matrix<int>& can_move, int mig_type, T time, const vector<T>& F, const vector<T>& M, 
+  const matrix<T>& mu, const vector<T>& L, int trace = 0) {
   /*
     produce the probability transition matrix over a time interval
       fleet_regions: n_fleets; which region each fleet is operating
@@ -120,9 +120,9 @@ matrix<T> get_P_t_base(vector<int> fleet_regions, matrix<int> can_move, int mig_
 //NOTE get_P_t here is defined as class T instead of Type and is not distiguishabled when used.
 //Not sure if this affects expected model performance.
 template <class T>
-matrix<T> get_P_t(int age, int year, int stock, int season, vector<int> fleet_regions, matrix<int> fleet_seasons,
-  array<int> can_move, vector<int> mig_type, T time, array<T> FAA, array<T>log_M, 
-  array<T> mu, matrix<T> L, int trace = 0) {
+matrix<T> get_P_t(int age, int year, int stock, int season, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons,
+  array<int>& can_move, const vector<int>& mig_type, T time, array<T>& FAA, array<T>& log_M, 
+  array<T>& mu, const matrix<T>& L, int trace = 0) {
   /*
     produce the probability transition matrix for a given stock, age, season, year
                 age: which age
@@ -166,9 +166,9 @@ matrix<T> get_P_t(int age, int year, int stock, int season, vector<int> fleet_re
 }
 
 template <class T>
-matrix<T> get_P_t(int age, int stock, int season, vector<int> fleet_regions, matrix<int> fleet_seasons,
-  array<int> can_move, vector<int> mig_type, T time, matrix<T> FAA, array<T>log_M, 
-  array<T> mu, vector<T> L, int trace = 0) {
+matrix<T> get_P_t(int age, int stock, int season, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons,
+  array<int>& can_move, const vector<int>& mig_type, T time, const matrix<T>& FAA, array<T>& log_M, 
+  array<T>& mu, const vector<T>& L, int trace = 0) {
   /*
     produce the probability transition matrix for a given stock, age, season FROM YEAR-SPECIFIC PARAMETERS
                 age: which age
@@ -211,7 +211,7 @@ matrix<T> get_P_t(int age, int stock, int season, vector<int> fleet_regions, mat
 }
 
 template <class T>
-matrix<T> get_S(matrix<T> P, int n_regions){
+matrix<T> get_S(const matrix<T>& P, int n_regions){
   /*
     extract the submatrix from a PTM that contains the proportions surviving in each region
               P: the probablity transition matrix
@@ -224,7 +224,7 @@ matrix<T> get_S(matrix<T> P, int n_regions){
 }
 
 template <class T>
-matrix<T> get_D(matrix<T> P, int n_regions, int n_fleets){
+matrix<T> get_D(const matrix<T>& P, int n_regions, int n_fleets){
   /*
     extract the submatrix from a PTM that contains the proportions captured by each fleet in each region
               P: the probablity transition matrix
@@ -238,8 +238,8 @@ matrix<T> get_D(matrix<T> P, int n_regions, int n_fleets){
 }
 
 template <class Type>
-array<Type> get_annual_Ps(int n_years_model, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, vector<Type> fracyr_seasons,
-  array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+array<Type> get_annual_Ps(int n_years_model, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& fracyr_seasons,
+  array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the annual probability transition matrix for a given stock, age, season, year
       fleet_regions: n_fleets; which region each fleet is operating
@@ -280,8 +280,8 @@ array<Type> get_annual_Ps(int n_years_model, vector<int> fleet_regions, matrix<i
 }
 
 template <class Type>
-array<Type> update_annual_Ps(int y, array<Type> annual_Ps, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, vector<Type> fracyr_seasons,
-  array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+void update_annual_Ps(int y, array<Type>& annual_Ps, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& fracyr_seasons,
+  array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the annual probability transition matrix for a given stock, age, season, year
       fleet_regions: n_fleets; which region each fleet is operating
@@ -303,7 +303,6 @@ array<Type> update_annual_Ps(int y, array<Type> annual_Ps, vector<int> fleet_reg
   int P_dim = n_regions + n_fleets + 1; // probablity transition matrix is P_dim x P_dim
   //get probability transition matrices for yearly survival, movement, capture...
   //also get annual NAA at spawning and NAA for each index along the way.
-  array<Type> updated_annual_Ps = annual_Ps;
   matrix<Type> I_mat(P_dim,P_dim);
   I_mat.setZero();  
   for(int i = 0; i < P_dim; i++) I_mat(i,i) = 1.0;
@@ -315,14 +314,13 @@ array<Type> update_annual_Ps(int y, array<Type> annual_Ps, vector<int> fleet_reg
       matrix<Type> P_t = get_P_t(a, y, s, t, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons(t), FAA, log_M, mu, L);
       P_y = P_y * P_t;
     }
-    for(int i = 0; i < P_dim; i++) for(int j = 0; j < P_dim; j++) updated_annual_Ps(s,y,a,i,j) = P_y(i,j);
+    for(int i = 0; i < P_dim; i++) for(int j = 0; j < P_dim; j++) annual_Ps(s,y,a,i,j) = P_y(i,j);
   }
-  return updated_annual_Ps;
 }
 
 template <class Type>
-array<Type> get_annual_SAA_spawn(int n_years_model, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, vector<Type> fracyr_seasons,
-  matrix<Type> fracyr_SSB, vector<int> spawn_seasons, array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+array<Type> get_annual_SAA_spawn(int n_years_model, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& fracyr_seasons,
+  const matrix<Type>& fracyr_SSB, const vector<int>& spawn_seasons, array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the annual survival probabilities up to time of spawning for a given stock, age, season, year
       fleet_regions: n_fleets; which region each fleet is operating
@@ -363,8 +361,8 @@ array<Type> get_annual_SAA_spawn(int n_years_model, vector<int> fleet_regions, m
 }
 
 template <class Type>
-array<Type> update_annual_SAA_spawn(int y, array<Type> annual_SAA_spawn, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, vector<Type> fracyr_seasons,
-  matrix<Type> fracyr_SSB, vector<int> spawn_seasons, array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+void update_annual_SAA_spawn(int y, array<Type>& annual_SAA_spawn, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, const vector<Type>& fracyr_seasons,
+  const matrix<Type>& fracyr_SSB, const vector<int>& spawn_seasons, array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the annual survival probabilities up to time of spawning for a given stock, age, season, year
       fleet_regions: n_fleets; which region each fleet is operating
@@ -384,7 +382,6 @@ array<Type> update_annual_SAA_spawn(int y, array<Type> annual_SAA_spawn, vector<
   int n_ages = log_M.dim(3);
   int P_dim = n_regions + n_fleets + 1; // probablity transition matrix is P_dim x P_dim
 
-  array<Type> updated_annual_SAA_spawn = annual_SAA_spawn;
   matrix<Type> I_mat(P_dim,P_dim);
   I_mat.setZero();  
   for(int i = 0; i < P_dim; i++) I_mat(i,i) = 1.0;
@@ -398,14 +395,13 @@ array<Type> update_annual_SAA_spawn(int y, array<Type> annual_SAA_spawn, vector<
     }
     //P(0,t) x P(t_s-t): PTM over interval from to time of spawning within the season
     matrix<Type> P_SSB = P_y * get_P_t(a, y, s, spawn_seasons(s)-1, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_SSB(y,s), FAA, log_M, mu, L);
-    for(int i = 0; i < n_regions; i++) for(int j = 0; j < n_regions; j++) updated_annual_SAA_spawn(s,y,a,i,j) = P_SSB(i,j);
+    for(int i = 0; i < n_regions; i++) for(int j = 0; j < n_regions; j++) annual_SAA_spawn(s,y,a,i,j) = P_SSB(i,j);
   }
-  return updated_annual_SAA_spawn;
 }
 
 template <class Type>
-array<Type> get_seasonal_Ps_y(int y, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type, 
-  vector<Type> fracyr_seasons, array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L){
+array<Type> get_seasonal_Ps_y(int y, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type, 
+  const vector<Type>& fracyr_seasons, array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L){
   /*
     produce the probability transition matrices for each stock, season, age for year y
       fleet_regions: n_fleets; which region each fleet is operating
@@ -436,9 +432,9 @@ array<Type> get_seasonal_Ps_y(int y, vector<int> fleet_regions, matrix<int> flee
 
 
 template <class Type>
-array<Type> get_eq_SAA(int y, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, 
-  vector<int> mig_type, array<Type> FAA, array<Type> log_M, array<Type> mu, matrix<Type> L, 
-  vector<Type> fracyr_seasons, int small_dim){
+array<Type> get_eq_SAA(int y, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, 
+  const vector<int>& mig_type, array<Type>& FAA, array<Type>& log_M, array<Type>& mu, const matrix<Type>& L, 
+  const vector<Type>& fracyr_seasons, int small_dim){
   /* 
     calculate equilibrium survival (at age) by stock and region. If movement is set up approriately 
     all fish can be made to return to a single spawning region for each stock.
@@ -1,5 +1,7 @@
 #include <iostream>
+#include <vector>
 #include "helper_functions.hpp"
+#include "ar1_re.hpp"
 #include "age_comp_osa.hpp"
 #include "age_comp_sim.hpp"
 #include "ecov.hpp"
@@ -0,0 +1,446 @@
+// Random effects module: Gaussian AR1-based processes in 1, 2 and 3 dimensions shared by all process errors (NAA, M, movement, selectivity,
+// catchability, extra mortality, Ecov). The *_re densities are evaluated through the sparse (tridiagonal or Kronecker) precision matrices
+// and the samplers can start conditional on the values before ystart. Correlations and sds are on the natural scale.
+// dar1, d2dar1, rar1, r2dar1 are the conditional (hand-written) alternatives used when use_alt_AR1 = 1 and take transformed parameters.
+
+template <class Type>
+Type d2dar1(array<Type> delta, Type tf_rho_r, Type tf_rho_c, vector<Type> log_sig_c, int use_dns=1){
+  
+  Type rho_r = geninvlogit(tf_rho_r, Type(-1), Type(1), Type(1)); //rho_year
+  Type rho_c = geninvlogit(tf_rho_c,Type(-1), Type(1), Type(1)); //rho_age
+  vector<Type> sig_c = exp(log_sig_c); //sd at age
+  vector<Type> marg_sig = sig_c * pow((1 - pow(rho_r,2))*(1 - pow(rho_c,2)),-0.5); // marginal at age across years and ages
+  vector<Type> sig_r1 = sig_c * pow(1-pow(rho_r,2),-0.5); //marginal sd at age across years
+  Type sig_c1 = sig_c(0) * pow(1-pow(rho_c,2),-0.5); //marginal sd age 1 across ages given year
+  Type res = 0;
+  if(use_dns == 0){
+    //first row
+    res -= dnorm(delta(0,0), Type(0), marg_sig(0),1); //marginal across year and age
+    for(int a = 1; a < delta.dim(1); a++){
+      res -= dnorm(delta(0,a), rho_c * delta(0,a-1) * sig_c(a) / sig_c(a-1), sig_r1(a), 1); //marginal across years conditional on age a-1
+    }
+    //subsequent rows
+    for(int y = 1; y < delta.dim(0); y++){
+      res -= dnorm(delta(y,0), rho_r * delta(y-1,0), sig_c1, 1); //marginal at age 1 across ages and conditional on year y-1
+    }
+    for(int y = 1; y < delta.dim(0); y++) {
+      for(int a = 1; a < delta.dim(1); a++) {
+        res -= dnorm(delta(y,a), rho_r *delta(y-1,a) + rho_c * (delta(y,a-1) - rho_r * delta(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a), 1); 
+      }
+    }
+  } else{
+    using namespace density;
+    res = SEPARABLE(VECSCALE(AR1(rho_c), marg_sig), AR1(rho_r))(delta);
+  }
+  return res;
+}
+
+template <class Type>
+array<Type> r2dar1(array<Type> delta, Type tf_rho_r, Type tf_rho_c, vector<Type> log_sig_c, int use_dns=1, int ystart=0, int bias_correct=0){
+  
+  Type rho_r = geninvlogit(tf_rho_r, Type(-1), Type(1), Type(1)); //rho_year (rows)
+  Type rho_c = geninvlogit(tf_rho_c,Type(-1), Type(1), Type(1)); //rho_age (columns)
+  vector<Type> sig_c = exp(log_sig_c); //conditional sd at age
+  vector<Type> marg_sig = sig_c * pow((1 - pow(rho_r,2))*(1 - pow(rho_c,2)),-0.5); // marginal at age across years and ages
+  vector<Type> sig_r1 = sig_c * pow(1-pow(rho_r,2),-0.5); //marginal sd at age across years
+  Type sig_c1 = sig_c(0) * pow(1-pow(rho_c,2),-0.5); //marginal sd age 1 across ages given year
+  // Type res = 0;
+  array<Type> delta_out = delta;
+  if(use_dns == 0){
+    vector<Type> mu_c(marg_sig.size());
+    mu_c.setZero();
+    if(bias_correct) mu_c = - 0.5 * marg_sig * marg_sig;
+    if(ystart == 0){ //first row, no conditioning on previous years
+      delta_out(0,0) = rnorm(mu_c(0), marg_sig(0)); //marginal across year and age at age 1
+      // if(bias_correct) delta_out(0,0) -= 0.5 * pow(marg_sig(0),2);
+      for(int a = 1; a < delta.dim(1); a++){
+        delta_out(0,a) = rnorm(mu_c(a) + (delta_out(0,a-1) - mu_c(a-1)) * rho_c * sig_c(a) / sig_c(a-1), sig_r1(a)); //marginal across years conditional on age a-1
+        // if(bias_correct) delta_out(0,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_c * sig_c(a-1)/sig_c(a));
+      }
+      for(int y = 1; y < delta.dim(0); y++){
+        delta_out(y,0) = rnorm(rho_r * delta_out(y-1,0), sig_c1); //marginal at age 1 across ages and conditional on year y-1
+        delta_out(y,0) += (1 - rho_r) * mu_c(0);
+        // if(bias_correct) delta_out(y,0) -= 0.5 * pow(marg_sig(0),2) * (1-rho_r);
+        for(int a = 1; a < delta.dim(1); a++) {
+          delta_out(y,a) = rnorm(rho_r *delta_out(y-1,a) + rho_c * (delta_out(y,a-1) - rho_r * delta_out(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a)); 
+          delta_out(y,a) += (1 - rho_r) * (mu_c(a) - mu_c(a-1) * rho_c * sig_c(a)/sig_c(a-1));
+          // if(bias_correct) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_r) * (1 - rho_c * sig_c(a-1)/sig_c(a));
+        }
+      }
+    } else {
+      //subsequent rows
+      for(int y = ystart; y < delta.dim(0); y++){
+        delta_out(y,0) = rnorm(rho_r * delta_out(y-1,0), sig_c1); //marginal at age 1 across ages and conditional on year y-1
+        delta_out(y,0) += (1 - rho_r) * mu_c(0);
+        // if(bias_correct) delta_out(y,0) -= 0.5 * pow(marg_sig(0),2) * (1-rho_r);
+        for(int a = 1; a < delta.dim(1); a++) {
+          delta_out(y,a) = rnorm(rho_r *delta_out(y-1,a) + rho_c * (delta_out(y,a-1) - rho_r * delta_out(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a)); 
+          delta_out(y,a) += (1 - rho_r) * (mu_c(a) - mu_c(a-1) * rho_c * sig_c(a)/sig_c(a-1));
+          // if(bias_correct) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_r) * (1 - rho_c * sig_c(a-1)/sig_c(a));
+        }
+      }
+    }
+  } else{
+    using namespace density;
+    SEPARABLE(VECSCALE(AR1(rho_c), marg_sig),AR1(rho_r)).simulate(delta_out); // scaled here
+    if(bias_correct) for(int y = 0; y < delta.dim(0); y++) for(int a = 0; a < delta.dim(1); a++) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2);
+  }
+  return delta_out;
+}
+
+template <class Type>
+Type dar1(vector<Type> delta, Type tf_rho, Type log_sig, int use_dns){
+  
+  Type rho = geninvlogit(tf_rho, Type(-1), Type(1), Type(1)); 
+  Type sig = exp(log_sig); 
+  Type marg_sig = sig * pow(1 - pow(rho,2),-0.5);
+  Type res = 0;
+  if(use_dns == 0){
+    res -= dnorm(delta(0), Type(0), marg_sig,1); //marginal across year and age
+    for(int y = 1; y < delta.size(); y++){
+      res -= dnorm(delta(y), rho * delta(y-1), sig, 1); //marginal at age 1 and conditional on year y-1
+    }
+  } else{
+    using namespace density;
+    res = SCALE(AR1(rho), marg_sig)(delta);
+  }
+  return res;
+}
+
+
+template <class Type>
+vector<Type> rar1(vector<Type> delta, Type tf_rho, Type log_sig, int use_dns, int ystart=0, int bias_correct=0){
+  
+  Type rho = geninvlogit(tf_rho, Type(-1), Type(1), Type(1)); 
+  Type sig = exp(log_sig); 
+  Type marg_sig = sig * pow(1 - pow(rho,2),-0.5);
+  vector<Type> delta_out = delta;
+  if(use_dns == 0){
+    if(ystart == 0) {
+      delta_out(0) = rnorm(Type(0), marg_sig); //marginal across year and age
+      if(bias_correct) delta_out(0) -= 0.5*pow(marg_sig,2);
+      for(int y = 1; y < delta.size(); y++){
+        delta_out(y) = rnorm(rho * delta_out(y-1), sig); //marginal at age 1 and conditional on year y-1
+        if(bias_correct) delta_out(y) -= 0.5*pow(marg_sig,2) * (1-rho);
+      }
+    } else {
+      for(int y = ystart; y < delta.size(); y++) {
+        delta_out(y) = rnorm(rho * delta_out(y-1), sig);
+        if(bias_correct) delta_out(y) -= 0.5*pow(marg_sig,2) * (1-rho);
+      }
+    }
+  } else {
+    using namespace density;
+    SCALE(AR1(rho), marg_sig).simulate(delta_out);
+    if(bias_correct) delta_out -= 0.5*pow(marg_sig,2);
+  }
+  return delta_out;
+}
+
+template <class Type>
+Eigen::SparseMatrix<Type> get_AR1_Q_sub(Type rho, vector<int> use){
+  /*
+    precision matrix of a unit-variance AR1 process over the positions where use == 1, conditional on the process being 0 at the 
+    other positions. It is the corresponding sub-block of the tridiagonal AR1 precision, so neighbours are only linked when they 
+    are adjacent in the full process.
+          rho: AR1 correlation
+          use: 0/1 for each position of the full process
+  */
+  int n = use.size();
+  vector<int> ind(n); //position in the sub-block
+  int n_use = 0;
+  for(int i = 0; i < n; i++) {
+    ind(i) = n_use;
+    if(use(i)) n_use++;
+  }
+  Type c = 1/(1 - rho*rho);
+  std::vector< Eigen::Triplet<Type> > tripletList;
+  for(int i = 0; i < n; i++) if(use(i)) {
+    Type d = c * (1 + rho*rho); //interior
+    if(n == 1) d = Type(1);
+    else if((i == 0) | (i == n-1)) d = c;
+    tripletList.push_back(Eigen::Triplet<Type>(ind(i), ind(i), d));
+    if(i < n-1) if(use(i+1)) {
+      tripletList.push_back(Eigen::Triplet<Type>(ind(i), ind(i+1), -rho * c));
+      tripletList.push_back(Eigen::Triplet<Type>(ind(i+1), ind(i), -rho * c));
+    }
+  }
+  Eigen::SparseMatrix<Type> Q(n_use, n_use);
+  Q.setFromTriplets(tripletList.begin(), tripletList.end());
+  return Q;
+}
+
+template <class Type>
+matrix<Type> ar1_Q_rows(matrix<Type> Z, Type rho){
+  /*
+    product Q Z where Q is the tridiagonal precision of a unit-variance AR1 process over the rows of Z. 
+  */
+  int n_r = Z.rows();
+  if(n_r == 1) return Z;
+  Type c = 1/(1 - rho*rho);
+  matrix<Type> W(n_r, Z.cols());
+  W.row(0) = c * (Z.row(0) - rho * Z.row(1));
+  for(int i = 1; i < n_r-1; i++) W.row(i) = c * ((1 + rho*rho) * Z.row(i) - rho * (Z.row(i-1) + Z.row(i+1)));
+  W.row(n_r-1) = c * (Z.row(n_r-1) - rho * Z.row(n_r-2));
+  return W;
+}
+
+template <class Type>
+Type dsepgmrf(matrix<Type> x, Eigen::SparseMatrix<Type> Q_c, Type rho_r, vector<Type> sig_c){
+  /*
+    negative log-density of a separable GMRF: x = Z * diag(sig_c), vec(Z) ~ N(0, (Q_c x Q_r)^-1) where Q_r is the precision of a unit-variance 
+    AR1 over rows (years) with correlation rho_r. Q_c is the (sparse) precision over columns within a row. Only the structural non-zeros of 
+    Q_c and the tridiagonal Q_r are used for the quadratic form, so the Hessian wrt x is as sparse as the precision.
+              x: n_r x n_c
+            Q_c: n_c x n_c precision of (unscaled) columns within a row
+          rho_r: AR1 correlation across rows
+          sig_c: n_c scale of each column
+  */
+  int n_r = x.rows(), n_c = x.cols();
+  matrix<Type> Z(n_r, n_c);
+  for(int j = 0; j < n_c; j++) for(int i = 0; i < n_r; i++) Z(i,j) = x(i,j)/sig_c(j);
+  matrix<Type> W = ar1_Q_rows(Z, rho_r);
+  matrix<Type> V = W * Q_c;
+  Type quad = (V.array() * Z.array()).sum();
+  Type logdetQ_c = 0;
+  if(n_c == 1) logdetQ_c = log(Q_c.coeff(0,0));
+  else {
+    matrix<Type> Q_c_dense = Q_c.toDense();
+    logdetQ_c = atomic::logdet(Q_c_dense);
+  }
+  Type logdetQ = - Type(n_c * (n_r-1)) * log(1 - rho_r*rho_r) + Type(n_r) * logdetQ_c;
+  logdetQ -= 2 * Type(n_r) * log(sig_c).sum();
+  return Type(0.5) * (Type(n_r*n_c) * log(2*M_PI) - logdetQ + quad);
+}
+
+template <class Type>
+matrix<Type> rsepgmrf(matrix<Type> x, Eigen::SparseMatrix<Type> Q_c, Type rho_r, vector<Type> sig_c, int ystart = 0, int bias_correct = 0){
+  /*
+    simulate from the separable GMRF in dsepgmrf. Rows before ystart are kept and rows from ystart on are simulated conditional on them.
+    If bias_correct = 1, the mean of each column is -0.5 times its marginal variance.
+  */
+  int n_r = x.rows(), n_c = x.cols();
+  matrix<Type> x_out = x;
+  matrix<Type> Q_c_dense = Q_c.toDense();
+  matrix<Type> S_c = atomic::matinv(Q_c_dense);
+  density::MVNORM_t<Type> mvn(S_c);
+  vector<Type> z(n_c), mu(n_c);
+  mu.setZero();
+  if(bias_correct) for(int j = 0; j < n_c; j++) mu(j) = -0.5 * sig_c(j) * sig_c(j) * S_c(j,j);
+  if(ystart > 0) for(int j = 0; j < n_c; j++) z(j) = (x(ystart-1,j) - mu(j))/sig_c(j);
+  for(int i = ystart; i < n_r; i++) {
+    if(i == 0) z = mvn.simulate();
+    else z = rho_r * z + sqrt(1 - rho_r*rho_r) * mvn.simulate();
+    for(int j = 0; j < n_c; j++) x_out(i,j) = mu(j) + sig_c(j) * z(j);
+  }
+  return x_out;
+}
+
+template <class Type>
+matrix<Type> get_unit_cor_Q(vector<Type> theta, int n_u){
+  /*
+    precision of an unstructured correlation matrix among n_u units (stocks, regions). theta has (at least) n_u*(n_u-1)/2 elements and is 
+    the parameterization of density::UNSTRUCTURED_CORR. For n_u = 1 the precision is 1.
+  */
+  matrix<Type> Q_u(n_u, n_u);
+  Q_u.setIdentity();
+  if(n_u > 1) {
+    vector<Type> theta_u = theta.head(n_u*(n_u-1)/2);
+    density::UNSTRUCTURED_CORR_t<Type> cor_u(theta_u);
+    matrix<Type> R_u = cor_u.cov();
+    Q_u = atomic::matinv(R_u);
+  }
+  return Q_u;
+}
+
+template <class Type>
+Eigen::SparseMatrix<Type> get_kron_Q_sub(matrix<Type> Q_u, Eigen::SparseMatrix<Type> Q_a, matrix<int> use){
+  /*
+    sparse Kronecker product Q_u x Q_a restricted to the cells where use == 1 (conditional on the process being 0 at the other cells, as in 
+    get_AR1_Q_sub). Cells are ordered by unit, then by position within unit. Only the structural non-zeros of Q_a are visited, so the result
+    has at most n_u^2 * nnz(Q_a) non-zeros.
+          Q_u: n_u x n_u (dense) precision across units
+          Q_a: n_a x n_a (sparse) precision within units
+          use: n_u x n_a 0/1 for each cell
+  */
+  int n_u = use.rows(), n_a = use.cols();
+  matrix<int> ind(n_u, n_a); //position of each cell in the sub-block
+  int n_use = 0;
+  for(int u = 0; u < n_u; u++) for(int a = 0; a < n_a; a++) {
+    ind(u,a) = n_use;
+    if(use(u,a)) n_use++;
+  }
+  std::vector< Eigen::Triplet<Type> > tripletList;
+  for(int k = 0; k < Q_a.outerSize(); k++) {
+    for(typename Eigen::SparseMatrix<Type>::InnerIterator it(Q_a,k); it; ++it) {
+      int a = it.row(), b = it.col();
+      for(int u = 0; u < n_u; u++) if(use(u,a)) for(int v = 0; v < n_u; v++) if(use(v,b)) {
+        tripletList.push_back(Eigen::Triplet<Type>(ind(u,a), ind(v,b), Q_u(u,v) * it.value()));
+      }
+    }
+  }
+  Eigen::SparseMatrix<Type> Q(n_use, n_use);
+  Q.setFromTriplets(tripletList.begin(), tripletList.end());
+  return Q;
+}
+
+template <class Type>
+Type dar1_re(vector<Type> x, Type rho, Type marg_sig, int bias_correct = 0){
+  /*
+    negative log-density of a stationary AR1 process, evaluated through its tridiagonal precision.
+                x: values
+              rho: correlation of successive values
+         marg_sig: marginal sd
+     bias_correct: 0/1 whether the mean of x is -0.5*marg_sig^2 (so that E(exp(x)) = 1)
+  */
+  int n = x.size();
+  vector<Type> z = x/marg_sig;
+  if(bias_correct) z += 0.5 * marg_sig;
+  Type quad = (z*z).sum();
+  if(n > 1) {
+    Type c = 1/(1 - rho*rho);
+    quad = c * ((1 + rho*rho) * quad - rho*rho * (z(0)*z(0) + z(n-1)*z(n-1)) - 2 * rho * (z.head(n-1) * z.tail(n-1)).sum());
+  }
+  Type logdetQ = - Type(n-1) * log(1 - rho*rho) - 2 * Type(n) * log(marg_sig);
+  return Type(0.5) * (Type(n) * log(2*M_PI) - logdetQ + quad);
+}
+
+template <class Type>
+vector<Type> dar1_re_terms(vector<Type> x, Type rho, Type marg_sig, int bias_correct = 0){
+  /*
+    negative log-density of a stationary AR1 process by element: the first value (marginal) and then each value conditional on the previous one.
+    sums to dar1_re. Use where the likelihood is reported by year.
+                x: values
+              rho: correlation of successive values
+         marg_sig: marginal sd
+     bias_correct: 0/1 whether the mean of x is -0.5*marg_sig^2 (so that E(exp(x)) = 1)
+  */
+  int n = x.size();
+  Type mu = Type(0);
+  if(bias_correct) mu = -0.5 * marg_sig * marg_sig;
+  Type cond_sig = marg_sig * sqrt(1 - rho*rho);
+  vector<Type> nll(n);
+  nll(0) = -dnorm(x(0), mu, marg_sig, 1);
+  for(int i = 1; i < n; i++) nll(i) = -dnorm(x(i), mu + rho * (x(i-1) - mu), cond_sig, 1);
+  return nll;
+}
+
+template <class Type>
+vector<Type> rar1_re(vector<Type> x, Type rho, Type marg_sig, int ystart = 0, int bias_correct = 0){
+  /*
+    simulate the AR1 process in dar1_re. Values before ystart are kept and values from ystart on are simulated conditional on them.
+  */
+  int n = x.size();
+  vector<Type> x_out = x;
+  Type mu = 0;
+  if(bias_correct) mu = -0.5 * marg_sig * marg_sig;
+  Type sig = marg_sig * sqrt(1 - rho*rho); //conditional sd
+  for(int i = ystart; i < n; i++) {
+    if(i == 0) x_out(i) = rnorm(mu, marg_sig);
+    else x_out(i) = rnorm(mu + rho * (x_out(i-1) - mu), sig);
+  }
+  return x_out;
+}
+
+template <class Type>
+Type d2dar1_re(matrix<Type> x, Type rho_r, Type rho_c, vector<Type> marg_sig_c, int bias_correct = 0){
+  /*
+    negative log-density of a separable 2D AR1 process over rows (years) and columns (ages, parameters) with column-specific marginal sd. 
+    Both precisions are tridiagonal, so the quadratic form vec(Z)'(Q_c x Q_r)vec(Z) = sum(Q_r Z Q_c * Z) needs no covariance matrix.
+                x: n_r x n_c
+            rho_r: AR1 correlation across rows
+            rho_c: AR1 correlation across columns
+       marg_sig_c: n_c marginal sd of each column
+     bias_correct: 0/1 whether the mean of each column is -0.5*marg_sig_c^2
+  */
+  int n_r = x.rows(), n_c = x.cols();
+  matrix<Type> Z(n_r, n_c);
+  for(int j = 0; j < n_c; j++) for(int i = 0; i < n_r; i++) {
+    Z(i,j) = x(i,j)/marg_sig_c(j);
+    if(bias_correct) Z(i,j) += 0.5 * marg_sig_c(j);
+  }
+  matrix<Type> W = ar1_Q_rows(Z, rho_r);
+  matrix<Type> Wt = W.transpose();
+  matrix<Type> V = ar1_Q_rows(Wt, rho_c); // Q_c W' = (Q_r Z Q_c)'
+  Type quad = (V.transpose().array() * Z.array()).sum();
+  Type logdetQ = - Type(n_c * (n_r-1)) * log(1 - rho_r*rho_r) - Type(n_r * (n_c-1)) * log(1 - rho_c*rho_c);
+  logdetQ -= 2 * Type(n_r) * log(marg_sig_c).sum();
+  return Type(0.5) * (Type(n_r*n_c) * log(2*M_PI) - logdetQ + quad);
+}
+
+template <class Type>
+Type d2dar1_re(matrix<Type> x, Type rho_r, Type rho_c, Type marg_sig, int bias_correct = 0){
+  vector<Type> marg_sig_c(x.cols());
+  marg_sig_c.fill(marg_sig);
+  return d2dar1_re(x, rho_r, rho_c, marg_sig_c, bias_correct);
+}
+
+template <class Type>
+matrix<Type> r2dar1_re(matrix<Type> x, Type rho_r, Type rho_c, vector<Type> marg_sig_c, int ystart = 0, int bias_correct = 0){
+  /*
+    simulate the separable 2D AR1 process in d2dar1_re. Rows before ystart are kept and rows from ystart on are simulated conditional on them.
+  */
+  int n_r = x.rows(), n_c = x.cols();
+  matrix<Type> x_out = x;
+  vector<Type> z(n_c), e(n_c), mu(n_c);
+  mu.setZero();
+  if(bias_correct) mu = Type(-0.5) * marg_sig_c * marg_sig_c;
+  if(ystart > 0) for(int j = 0; j < n_c; j++) z(j) = (x(ystart-1,j) - mu(j))/marg_sig_c(j);
+  for(int i = ystart; i < n_r; i++) {
+    e(0) = rnorm(Type(0), Type(1)); //unit-variance AR1 across columns
+    for(int j = 1; j < n_c; j++) e(j) = rho_c * e(j-1) + sqrt(1 - rho_c*rho_c) * rnorm(Type(0), Type(1));
+    if(i == 0) z = e;
+    else z = rho_r * z + sqrt(1 - rho_r*rho_r) * e;
+    for(int j = 0; j < n_c; j++) x_out(i,j) = mu(j) + marg_sig_c(j) * z(j);
+  }
+  return x_out;
+}
+
+template <class Type>
+matrix<Type> r2dar1_re(matrix<Type> x, Type rho_r, Type rho_c, Type marg_sig, int ystart = 0, int bias_correct = 0){
+  vector<Type> marg_sig_c(x.cols());
+  marg_sig_c.fill(marg_sig);
+  return r2dar1_re(x, rho_r, rho_c, marg_sig_c, ystart, bias_correct);
+}
+
+template <class Type>
+Type d3dar1_re(matrix<Type> x, Type rho_r, Type rho_c, matrix<Type> Q_u, matrix<int> use, vector<Type> marg_sig, int bias_correct = 0){
+  /*
+    negative log-density of a separable 3D process: AR1 across rows (years) and, within a row, the Kronecker product of the precision Q_u 
+    across units (e.g., stocks/regions, see get_unit_cor_Q) and an AR1 across positions (ages) within units. Only the cells with use == 1 are 
+    present (conditional on the others being 0), and the columns of x are these cells ordered as in get_kron_Q_sub. With one unit this is a 
+    2D AR1 where some ages may be missing.
+                x: n_r x sum(use)
+              Q_u: n_u x n_u precision across units
+              use: n_u x n_a 0/1 for each cell
+         marg_sig: sum(use) marginal sd of each cell when no cells are missing
+     bias_correct: 0/1 whether the mean of each column is -0.5 times its marginal variance
+  */
+  int n_c = x.cols();
+  vector<int> use_a(use.cols());
+  use_a.fill(1);
+  Eigen::SparseMatrix<Type> Q_c = get_kron_Q_sub(Q_u, get_AR1_Q_sub(rho_c, use_a), use);
+  matrix<Type> x_c = x;
+  if(bias_correct) {
+    vector<Type> var_c = marg_sig * marg_sig;
+    if(n_c < use.size()) { //missing cells change the marginal variances
+      matrix<Type> Q_c_dense = Q_c.toDense();
+      matrix<Type> S_c = atomic::matinv(Q_c_dense);
+      for(int j = 0; j < n_c; j++) var_c(j) *= S_c(j,j);
+    }
+    for(int j = 0; j < n_c; j++) for(int i = 0; i < x.rows(); i++) x_c(i,j) += 0.5 * var_c(j);
+  }
+  return dsepgmrf(x_c, Q_c, rho_r, marg_sig);
+}
+
+template <class Type>
+matrix<Type> r3dar1_re(matrix<Type> x, Type rho_r, Type rho_c, matrix<Type> Q_u, matrix<int> use, vector<Type> marg_sig, int ystart = 0, 
+  int bias_correct = 0){
+  /*
+    simulate the separable 3D process in d3dar1_re. Rows before ystart are kept and rows from ystart on are simulated conditional on them.
+  */
+  vector<int> use_a(use.cols());
+  use_a.fill(1);
+  Eigen::SparseMatrix<Type> Q_c = get_kron_Q_sub(Q_u, get_AR1_Q_sub(rho_c, use_a), use);
+  return rsepgmrf(x, Q_c, rho_r, marg_sig, ystart, bias_correct);
+}
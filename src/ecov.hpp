@@ -9,7 +9,6 @@ matrix<Type> get_nll_Ecov(vector<int> Ecov_model, matrix<Type> Ecov_process_pars
       Ecov_use_re: whether to include random effects in the likelihood
         years_use: possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_Ecov = Ecov_model.size();
   int n_y = years_use.size();
   //int n_y = Ecov_re.rows();
@@ -36,7 +35,7 @@ matrix<Type> get_nll_Ecov(vector<int> Ecov_model, matrix<Type> Ecov_process_pars
       vector<Type> re_i(n_y);
       for(int y = 0; y < n_y; y++) re_i(y) = Ecov_re(years_use(y),i);
       //vector<Type> re_i = Ecov_re.col(i);
-      nll_Ecov(0,i) += SCALE(AR1(Ecov_phi), Ecov_sig)(re_i);
+      nll_Ecov(0,i) += dar1_re(re_i, Ecov_phi, Ecov_sig);
     }
   }
   return(nll_Ecov);
@@ -75,6 +74,70 @@ matrix<Type> get_Ecov(vector<int> Ecov_model, matrix<Type> Ecov_process_pars, ma
   return(Ecov_x);
 }
 
+template<class Type>
+array<Type> get_Ecov_kf(vector<int> Ecov_model, matrix<Type> Ecov_process_pars, vector<int> Ecov_marginalize, matrix<Type> Ecov_obs, 
+  matrix<int> Ecov_use_obs, matrix<Type> Ecov_obs_logsigma, vector<int> years_use, int n_y){
+  /* 
+     Kalman filter and (Rauch-Tung-Striebel) smoother for Ecovs that are integrated out of the likelihood exactly rather than by Laplace.
+     The RW and AR1 process models with normal observation errors are linear-Gaussian, so no Ecov_re are needed for these Ecovs.
+       Ecov_model: which time series model to use (RW, AR1)
+        Ecov_process_pars: parameters for time series models for each Ecov (columns)
+         Ecov_marginalize: 0/1 whether to use the filter for each Ecov
+                 Ecov_obs: observations (n_years_Ecov x n_Ecov)
+             Ecov_use_obs: 0/1 whether to use each observation
+        Ecov_obs_logsigma: log standard deviations of observations
+                years_use: possibly a subset of years to use for evaluating likelihood. normally = 0,....,n_years_Ecov-1
+                      n_y: number of years of the latent Ecov (including any projection years)
+     returns array (n_y x n_Ecov x 3): nll contribution of each observation, smoothed mean, and smoothed variance of the latent Ecov
+  */
+  int n_Ecov = Ecov_model.size();
+  int n_obs = Ecov_obs.rows();
+  array<Type> kf(n_y, n_Ecov, 3);
+  kf.setZero();
+  vector<int> use_y(n_y);
+  use_y.setZero();
+  for(int y = 0; y < years_use.size(); y++) use_y(years_use(y)) = 1;
+
+  for(int i = 0; i < n_Ecov; i++) if((Ecov_model(i) > 0) & (Ecov_marginalize(i) == 1)){
+    Type Ecov_phi = Type(1), Ecov_mu = Type(0);
+    Type Ecov_var = exp(Type(2) * Ecov_process_pars(1,i)); // conditional variance
+    vector<Type> m_p(n_y), P_p(n_y), m_f(n_y), P_f(n_y); // predicted and filtered means and variances
+    if(Ecov_model(i) == 1){ // RW: Ecov_x in year 1 is a fixed effect
+      m_p(0) = Ecov_process_pars(0,i);
+      P_p(0) = Type(0);
+    }
+    if(Ecov_model(i) == 2){ // AR1: start from stationary distribution
+      Ecov_phi = geninvlogit(Ecov_process_pars(2,i), Type(-1), Type(1), Type(1));
+      Ecov_mu = Ecov_process_pars(0,i);
+      m_p(0) = Ecov_mu;
+      P_p(0) = Ecov_var/(Type(1) - Ecov_phi * Ecov_phi);
+    }
+    for(int y = 0; y < n_y; y++){
+      if(y > 0){
+        m_p(y) = Ecov_mu + Ecov_phi * (m_f(y-1) - Ecov_mu);
+        P_p(y) = Ecov_phi * Ecov_phi * P_f(y-1) + Ecov_var;
+      }
+      m_f(y) = m_p(y);
+      P_f(y) = P_p(y);
+      if(y < n_obs) if((use_y(y) == 1) & (Ecov_use_obs(y,i) == 1)){
+        Type S = P_p(y) + exp(Type(2) * Ecov_obs_logsigma(y,i));
+        kf(y,i,0) -= dnorm(Ecov_obs(y,i), m_p(y), sqrt(S), 1);
+        Type K = P_p(y)/S;
+        m_f(y) += K * (Ecov_obs(y,i) - m_p(y));
+        P_f(y) *= Type(1) - K;
+      }
+    }
+    kf(n_y-1,i,1) = m_f(n_y-1);
+    kf(n_y-1,i,2) = P_f(n_y-1);
+    for(int y = n_y-2; y >= 0; y--){
+      Type J = Ecov_phi * P_f(y)/P_p(y+1);
+      kf(y,i,1) = m_f(y) + J * (kf(y+1,i,1) - m_p(y+1));
+      kf(y,i,2) = P_f(y) + J * J * (kf(y+1,i,2) - P_p(y+1));
+    }
+  }
+  return(kf);
+}
+
 template<class Type>
 matrix<Type> simulate_Ecov_re(vector<int> Ecov_model, matrix<Type> Ecov_process_pars, matrix<Type> Ecov_re, vector<int> Ecov_use_re, 
   vector<int> years_use){
@@ -86,7 +149,6 @@ matrix<Type> simulate_Ecov_re(vector<int> Ecov_model, matrix<Type> Ecov_process_
       Ecov_use_re: whether to simulate random effects (and whether to include likelihood contributions)
         years_use: possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
   */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_Ecov = Ecov_model.size();
   int n_y = years_use.size();
   //int n_y = Ecov_re.rows();
@@ -110,8 +172,7 @@ matrix<Type> simulate_Ecov_re(vector<int> Ecov_model, matrix<Type> Ecov_process_
         Type Ecov_sig = exp(Ecov_process_pars(1,i)) *pow(1 - pow(Ecov_phi,2),-0.5); // marginal sd
         //vector<Type> re_i = re_sim.col(i);
         vector<Type> re_i(n_y);
-        AR1(Ecov_phi).simulate(re_i);
-        re_i *= Ecov_sig;
+        re_i = rar1_re(re_i, Ecov_phi, Ecov_sig);
         for(int y = 0; y < n_y; y++) re_sim(years_use(y),i) = re_i(y);
       }
     }
@@ -229,3 +290,127 @@ matrix<Type> get_Ecov_lm(matrix<Type>Ecov_beta, matrix<Type>Ecov_out, int n_year
   return Ecov_lm;
 }
 
+
+/* 
+  Lagged and transformed Ecov columns keyed by (Ecov, first year, last year, polynomial degree). Effects on R, M, q, and mu 
+  for many stocks, ages, seasons, and regions usually share the same lag and link, so each unique column (get_Ecov_out and 
+  poly_trans) is computed once per evaluation and each cell only forms its linear predictor from the cached design matrix.
+*/
+template<class Type>
+struct Ecov_lm_cache {
+  matrix<Type> Ecov_x;
+  int n_years_model;
+  int n_years_proj;
+  vector<int> proj_Ecov_opt;
+  vector<int> avg_years;
+  matrix<Type> Ecov_use_proj;
+  vector<int> poly_fixed; //0/1 for each Ecov: use fixed orthogonal polynomial coefficients (poly_trans_fixed)
+  matrix<Type> poly_alpha;
+  matrix<Type> poly_norm2;
+  std::vector<int> out_Ecov, out_start, out_end; //keys of cached Ecov_out columns
+  std::vector<int> key_Ecov, key_start, key_end, key_poly; //keys of cached design matrices
+  std::vector<int> out_ind; //which cached Ecov_out column each design matrix uses
+  std::vector<vector<Type> > Ecov_out; //lagged, padded columns: unique (Ecov, first year, last year)
+  std::vector<matrix<Type> > X_poly; //design matrices: unique (Ecov, first year, last year, n_poly)
+
+  // Constructor 
+  Ecov_lm_cache(
+  matrix<Type> Ecov_x_,
+  int n_years_model_,
+  int n_years_proj_,
+  vector<int> proj_Ecov_opt_,
+  vector<int> avg_years_,
+  matrix<Type> Ecov_use_proj_,
+  vector<int> poly_fixed_,
+  matrix<Type> poly_alpha_,
+  matrix<Type> poly_norm2_) :
+    Ecov_x(Ecov_x_),
+    n_years_model(n_years_model_),
+    n_years_proj(n_years_proj_),
+    proj_Ecov_opt(proj_Ecov_opt_),
+    avg_years(avg_years_),
+    Ecov_use_proj(Ecov_use_proj_),
+    poly_fixed(poly_fixed_),
+    poly_alpha(poly_alpha_),
+    poly_norm2(poly_norm2_) {}
+
+  int get_out_ind(int i, int start, int end){
+    for(int k = 0; k < (int) out_Ecov.size(); k++) {
+      if((out_Ecov[k] == i) & (out_start[k] == start) & (out_end[k] == end)) return k;
+    }
+    //same calculations as get_Ecov_out for a single Ecov
+    vector<Type> out(n_years_model + n_years_proj);
+    out.setZero();
+    int ct = 0;
+    for(int y = start; y < end + 1 + n_years_proj; y++){
+      if(ct < n_years_model) {
+        out(ct) = Ecov_x(y,i);
+      } else { //projection year
+        if(proj_Ecov_opt(i) == 1) out(ct) = Ecov_x(y,i); //continue Ecov process
+        if(proj_Ecov_opt(i) == 2) { //average over avg_years
+          for(int ind = 0; ind < avg_years.size(); ind++) out(ct) += out(avg_years(ind))/Type(avg_years.size());
+        }
+        if(proj_Ecov_opt(i) == 3) out(ct) = out(n_years_model-1); //use terminal year
+        if(proj_Ecov_opt(i) == 4) out(ct) = Ecov_use_proj(ct-n_years_model,i); //user-defined ecov
+      }
+      ct++;
+    }
+    Ecov_out.push_back(out);
+    out_Ecov.push_back(i);
+    out_start.push_back(start);
+    out_end.push_back(end);
+    return Ecov_out.size() - 1;
+  }
+
+  int get_key(int i, int start, int end, int n_poly){
+    for(int k = 0; k < (int) key_Ecov.size(); k++) {
+      if((key_Ecov[k] == i) & (key_start[k] == start) & (key_end[k] == end) & (key_poly[k] == n_poly)) return k;
+    }
+    int o = get_out_ind(i, start, end);
+    if(n_poly == 1) X_poly.push_back(Ecov_out[o].matrix()); // n_poly = 1 if ecov effect is none or linear
+    else if(poly_fixed(i) == 1) {
+      vector<Type> alpha(poly_alpha.cols()), norm2(poly_norm2.cols());
+      for(int j = 0; j < alpha.size(); j++) alpha(j) = poly_alpha(i,j);
+      for(int j = 0; j < norm2.size(); j++) norm2(j) = poly_norm2(i,j);
+      X_poly.push_back(poly_trans_fixed(Ecov_out[o], n_poly, alpha, norm2));
+    }
+    else X_poly.push_back(poly_trans(Ecov_out[o], n_poly, n_years_model, n_years_proj));
+    key_Ecov.push_back(i);
+    key_start.push_back(start);
+    key_end.push_back(end);
+    key_poly.push_back(n_poly);
+    out_ind.push_back(o);
+    return key_Ecov.size() - 1;
+  }
+
+  // same as get_Ecov_out(Ecov_x, ..., ind_Ecov_out_start, ind_Ecov_out_end, ...), but from cached columns
+  matrix<Type> get_out(vector<int> ind_Ecov_out_start, vector<int> ind_Ecov_out_end){
+    int n_Ecov = Ecov_x.cols();
+    matrix<Type> out(n_years_model + n_years_proj, n_Ecov);
+    for(int i = 0; i < n_Ecov; i++) out.col(i) = Ecov_out[get_out_ind(i, ind_Ecov_out_start(i), ind_Ecov_out_end(i))].matrix();
+    return out;
+  }
+
+  // linear predictor for a single Ecov effect with coefficients beta (length = polynomial degree)
+  vector<Type> get_lm_i(int i, int start, int end, vector<Type> beta){
+    int k = get_key(i, start, end, beta.size());
+    vector<Type> lm(n_years_model + n_years_proj);
+    lm.setZero();
+    for(int y = 0; y < lm.size(); y++) for(int j = 0; j < beta.size(); j++){
+      lm(y) += beta(j) * X_poly[k](y,j); // poly transformation returns design matrix, don't need to take powers
+    }
+    return lm;
+  }
+
+  // same as get_Ecov_lm(Ecov_beta, get_Ecov_out(...), n_years_model, n_years_proj, n_poly_Ecov), but from cached design matrices
+  matrix<Type> get_lm(matrix<Type> Ecov_beta, vector<int> ind_Ecov_out_start, vector<int> ind_Ecov_out_end, vector<int> n_poly_Ecov){
+    int n_Ecov = Ecov_x.cols();
+    matrix<Type> Ecov_lm(n_years_model + n_years_proj, n_Ecov);
+    for(int i = 0; i < n_Ecov; i++){
+      vector<Type> beta(n_poly_Ecov(i));
+      for(int j = 0; j < n_poly_Ecov(i); j++) beta(j) = Ecov_beta(i,j);
+      Ecov_lm.col(i) = get_lm_i(i, ind_Ecov_out_start(i), ind_Ecov_out_end(i), beta).matrix();
+    }
+    return Ecov_lm;
+  }
+};
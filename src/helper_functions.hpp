@@ -366,13 +366,13 @@ matrix<Type> poly_trans(vector<Type> x, int degree, int n_years_model, int n_yea
     // degree 2
     vector<Type> Xi_proj(n_years_proj);
     Xi_proj = (x_centered_proj - alpha(0)).array() * X_proj.col(0).array() - beta(0);
-    X_proj.col(1) = Xi;
+    X_proj.col(1) = Xi_proj;
 
     // degree > 2
     if(degree > 2){
       for(int i=3; i<degree+1; i++){
         Xi_proj =  (x_centered_proj - alpha(i-2)).array() * X_proj.col(i-2).array() - beta(i-2)*X_proj.col(i-3).array();
-        X_proj.col(i-1) = Xi;      
+        X_proj.col(i-1) = Xi_proj;
       }
     }
 
@@ -386,136 +386,43 @@ matrix<Type> poly_trans(vector<Type> x, int degree, int n_years_model, int n_yea
   return finalX;
 }
 
+// orthogonal polynomials of 'x' with fixed recurrence coefficients alpha (length >= degree) and norm2 (length >= degree + 2),
+// e.g., attr(poly(x_obs, degree), "coefs") computed on the R side. Same as predict(poly(x_obs, degree), x) in R.
+// Unlike poly_trans, each row only depends on the same element of x, and no sums over years are taped.
 template <class Type>
-Type d2dar1(array<Type> delta, Type tf_rho_r, Type tf_rho_c, vector<Type> log_sig_c, int use_dns=1){
-  
-  Type rho_r = geninvlogit(tf_rho_r, Type(-1), Type(1), Type(1)); //rho_year
-  Type rho_c = geninvlogit(tf_rho_c,Type(-1), Type(1), Type(1)); //rho_age
-  vector<Type> sig_c = exp(log_sig_c); //sd at age
-  vector<Type> marg_sig = sig_c * pow((1 - pow(rho_r,2))*(1 - pow(rho_c,2)),-0.5); // marginal at age across years and ages
-  vector<Type> sig_r1 = sig_c * pow(1-pow(rho_r,2),-0.5); //marginal sd at age across years
-  Type sig_c1 = sig_c(0) * pow(1-pow(rho_c,2),-0.5); //marginal sd age 1 across ages given year
-  Type res = 0;
-  if(use_dns == 0){
-    //first row
-    res -= dnorm(delta(0,0), Type(0), marg_sig(0),1); //marginal across year and age
-    for(int a = 1; a < delta.dim(1); a++){
-      res -= dnorm(delta(0,a), rho_c * delta(0,a-1) * sig_c(a) / sig_c(a-1), sig_r1(a), 1); //marginal across years conditional on age a-1
-    }
-    //subsequent rows
-    for(int y = 1; y < delta.dim(0); y++){
-      res -= dnorm(delta(y,0), rho_r * delta(y-1,0), sig_c1, 1); //marginal at age 1 across ages and conditional on year y-1
-    }
-    for(int y = 1; y < delta.dim(0); y++) {
-      for(int a = 1; a < delta.dim(1); a++) {
-        res -= dnorm(delta(y,a), rho_r *delta(y-1,a) + rho_c * (delta(y,a-1) - rho_r * delta(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a), 1); 
-      }
-    }
-  } else{
-    using namespace density;
-    res = SEPARABLE(VECSCALE(AR1(rho_c), marg_sig), AR1(rho_r))(delta);
+matrix<Type> poly_trans_fixed(vector<Type> x, int degree, vector<Type> alpha, vector<Type> norm2)
+{
+  int n = x.size();
+  matrix<Type> Z(n, degree + 1);
+  for(int i = 0; i < n; i++){
+    Z(i,0) = Type(1);
+    Z(i,1) = x(i) - alpha(0);
+    for(int j = 2; j < degree + 1; j++) Z(i,j) = (x(i) - alpha(j-1)) * Z(i,j-1) - (norm2(j)/norm2(j-1)) * Z(i,j-2);
   }
-  return res;
+  matrix<Type> X(n, degree);
+  for(int j = 0; j < degree; j++) for(int i = 0; i < n; i++) X(i,j) = Z(i,j+1) / sqrt(norm2(j+2));
+  return X;
 }
 
+// double precision copies of parameters that are entirely fixed (mapped), see data$re_free. Quantities that only depend on
+// such parameters are constants, so they are evaluated in double precision rather than with the AD types and then converted back.
 template <class Type>
-array<Type> r2dar1(array<Type> delta, Type tf_rho_r, Type tf_rho_c, vector<Type> log_sig_c, int use_dns=1, int ystart=0, int bias_correct=0){
-  
-  Type rho_r = geninvlogit(tf_rho_r, Type(-1), Type(1), Type(1)); //rho_year (rows)
-  Type rho_c = geninvlogit(tf_rho_c,Type(-1), Type(1), Type(1)); //rho_age (columns)
-  vector<Type> sig_c = exp(log_sig_c); //conditional sd at age
-  vector<Type> marg_sig = sig_c * pow((1 - pow(rho_r,2))*(1 - pow(rho_c,2)),-0.5); // marginal at age across years and ages
-  vector<Type> sig_r1 = sig_c * pow(1-pow(rho_r,2),-0.5); //marginal sd at age across years
-  Type sig_c1 = sig_c(0) * pow(1-pow(rho_c,2),-0.5); //marginal sd age 1 across ages given year
-  // Type res = 0;
-  array<Type> delta_out = delta;
-  if(use_dns == 0){
-    vector<Type> mu_c(marg_sig.size());
-    mu_c.setZero();
-    if(bias_correct) mu_c = - 0.5 * marg_sig * marg_sig;
-    if(ystart == 0){ //first row, no conditioning on previous years
-      delta_out(0,0) = rnorm(mu_c(0), marg_sig(0)); //marginal across year and age at age 1
-      // if(bias_correct) delta_out(0,0) -= 0.5 * pow(marg_sig(0),2);
-      for(int a = 1; a < delta.dim(1); a++){
-        delta_out(0,a) = rnorm(mu_c(a) + (delta_out(0,a-1) - mu_c(a-1)) * rho_c * sig_c(a) / sig_c(a-1), sig_r1(a)); //marginal across years conditional on age a-1
-        // if(bias_correct) delta_out(0,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_c * sig_c(a-1)/sig_c(a));
-      }
-      for(int y = 1; y < delta.dim(0); y++){
-        delta_out(y,0) = rnorm(rho_r * delta_out(y-1,0), sig_c1); //marginal at age 1 across ages and conditional on year y-1
-        delta_out(y,0) += (1 - rho_r) * mu_c(0);
-        // if(bias_correct) delta_out(y,0) -= 0.5 * pow(marg_sig(0),2) * (1-rho_r);
-        for(int a = 1; a < delta.dim(1); a++) {
-          delta_out(y,a) = rnorm(rho_r *delta_out(y-1,a) + rho_c * (delta_out(y,a-1) - rho_r * delta_out(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a)); 
-          delta_out(y,a) += (1 - rho_r) * (mu_c(a) - mu_c(a-1) * rho_c * sig_c(a)/sig_c(a-1));
-          // if(bias_correct) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_r) * (1 - rho_c * sig_c(a-1)/sig_c(a));
-        }
-      }
-    } else {
-      //subsequent rows
-      for(int y = ystart; y < delta.dim(0); y++){
-        delta_out(y,0) = rnorm(rho_r * delta_out(y-1,0), sig_c1); //marginal at age 1 across ages and conditional on year y-1
-        delta_out(y,0) += (1 - rho_r) * mu_c(0);
-        // if(bias_correct) delta_out(y,0) -= 0.5 * pow(marg_sig(0),2) * (1-rho_r);
-        for(int a = 1; a < delta.dim(1); a++) {
-          delta_out(y,a) = rnorm(rho_r *delta_out(y-1,a) + rho_c * (delta_out(y,a-1) - rho_r * delta_out(y-1,a-1)) * sig_c(a) /sig_c(a-1), sig_c(a)); 
-          delta_out(y,a) += (1 - rho_r) * (mu_c(a) - mu_c(a-1) * rho_c * sig_c(a)/sig_c(a-1));
-          // if(bias_correct) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2) * (1 - rho_r) * (1 - rho_c * sig_c(a-1)/sig_c(a));
-        }
-      }
-    }
-  } else{
-    using namespace density;
-    SEPARABLE(VECSCALE(AR1(rho_c), marg_sig),AR1(rho_r)).simulate(delta_out); // scaled here
-    if(bias_correct) for(int y = 0; y < delta.dim(0); y++) for(int a = 0; a < delta.dim(1); a++) delta_out(y,a) -= 0.5 * pow(marg_sig(a),2);
-  }
-  return delta_out;
+array<double> fixed_as_double(array<Type> x){
+  array<double> y(x.dim);
+  for(int i = 0; i < x.size(); i++) y(i) = asDouble(x(i));
+  return y;
 }
 
 template <class Type>
-Type dar1(vector<Type> delta, Type tf_rho, Type log_sig, int use_dns){
-  
-  Type rho = geninvlogit(tf_rho, Type(-1), Type(1), Type(1)); 
-  Type sig = exp(log_sig); 
-  Type marg_sig = sig * pow(1 - pow(rho,2),-0.5);
-  Type res = 0;
-  if(use_dns == 0){
-    res -= dnorm(delta(0), Type(0), marg_sig,1); //marginal across year and age
-    for(int y = 1; y < delta.size(); y++){
-      res -= dnorm(delta(y), rho * delta(y-1), sig, 1); //marginal at age 1 and conditional on year y-1
-    }
-  } else{
-    using namespace density;
-    res = SCALE(AR1(rho), marg_sig)(delta);
-  }
-  return res;
+matrix<double> fixed_as_double(matrix<Type> x){
+  matrix<double> y(x.rows(), x.cols());
+  for(int i = 0; i < x.rows(); i++) for(int j = 0; j < x.cols(); j++) y(i,j) = asDouble(x(i,j));
+  return y;
 }
 
-
 template <class Type>
-vector<Type> rar1(vector<Type> delta, Type tf_rho, Type log_sig, int use_dns, int ystart=0, int bias_correct=0){
-  
-  Type rho = geninvlogit(tf_rho, Type(-1), Type(1), Type(1)); 
-  Type sig = exp(log_sig); 
-  Type marg_sig = sig * pow(1 - pow(rho,2),-0.5);
-  vector<Type> delta_out = delta;
-  if(use_dns == 0){
-    if(ystart == 0) {
-      delta_out(0) = rnorm(Type(0), marg_sig); //marginal across year and age
-      if(bias_correct) delta_out(0) -= 0.5*pow(marg_sig,2);
-      for(int y = 1; y < delta.size(); y++){
-        delta_out(y) = rnorm(rho * delta_out(y-1), sig); //marginal at age 1 and conditional on year y-1
-        if(bias_correct) delta_out(y) -= 0.5*pow(marg_sig,2) * (1-rho);
-      }
-    } else {
-      for(int y = ystart; y < delta.size(); y++) {
-        delta_out(y) = rnorm(rho * delta_out(y-1), sig);
-        if(bias_correct) delta_out(y) -= 0.5*pow(marg_sig,2) * (1-rho);
-      }
-    }
-  } else {
-    using namespace density;
-    SCALE(AR1(rho), marg_sig).simulate(delta_out);
-    if(bias_correct) delta_out -= 0.5*pow(marg_sig,2);
-  }
-  return delta_out;
+array<Type> double_as_Type(array<double> x){
+  array<Type> y(x.dim);
+  for(int i = 0; i < x.size(); i++) y(i) = Type(x(i));
+  return y;
 }
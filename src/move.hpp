@@ -122,7 +122,6 @@ array<Type> get_nll_mu(array<Type> mu_repars, array<Type> mu_re, matrix<int> mu_
    can_move: n_stocks x n_seasons x n_regions x n_regions 0/1 whether fish can move from one region to another
    years_use: is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
    */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = mu_re.dim(0);
   int n_ages = mu_re.dim(1);
   int n_seasons = mu_re.dim(2);
@@ -167,19 +166,19 @@ array<Type> get_nll_mu(array<Type> mu_repars, array<Type> mu_re, matrix<int> mu_
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
         vector<Type> mu_re_a(n_ages);
         for(int a = 0; a < n_ages; a++) mu_re_a(a) = mu_re(0,a,season_can_move-1,years_use(0),r,rr);
-        nll(0,season_can_move-1,r,rr) += SCALE(AR1(rho_mu_a), Sigma_MU)(mu_re_a);
+        nll(0,season_can_move-1,r,rr) += dar1_re(mu_re_a, rho_mu_a, Sigma_MU);
       }
       if(mu_model(r,rr) == 3) { //year re
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
         vector<Type> mu_re_y(n_y);
         for(int y = 0; y< n_y; y++) mu_re_y(y) = mu_re(0,0,season_can_move-1,years_use(y),r,rr);
-        nll(0,season_can_move-1,r,rr) += SCALE(AR1(rho_mu_y), Sigma_MU)(mu_re_y);
+        nll(0,season_can_move-1,r,rr) += dar1_re(mu_re_y, rho_mu_y, Sigma_MU);
       }
       if(mu_model(r,rr) == 4) { //age,year re
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-        array<Type> mu_re_ya(n_y,n_ages);
+        matrix<Type> mu_re_ya(n_y,n_ages);
         for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) mu_re_ya(y,a) = mu_re(0,a,season_can_move-1,years_use(y),r,rr);
-        nll(0,season_can_move-1,r,rr) += SCALE(SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)), Sigma_MU)(mu_re_ya); // must be array, not matrix!
+        nll(0,season_can_move-1,r,rr) += d2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
       }
     }
     if((mu_model(r,rr) > 5) & (mu_model(r,rr) <=8)) {//stock, RE
@@ -191,19 +190,19 @@ array<Type> get_nll_mu(array<Type> mu_repars, array<Type> mu_re, matrix<int> mu_
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
           for(int a = 0; a < n_ages; a++) mu_re_a(a) = mu_re(s,a,stock_season_can_move(s)-1,0,r,rr);
-          nll(s,stock_season_can_move(s)-1,r,rr) += SCALE(AR1(rho_mu_a), Sigma_MU)(mu_re_a);
+          nll(s,stock_season_can_move(s)-1,r,rr) += dar1_re(mu_re_a, rho_mu_a, Sigma_MU);
         }
         if(mu_model(r,rr) == 7) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
           for(int y = 0; y< n_y; y++) mu_re_y(y) = mu_re(s,0,stock_season_can_move(s)-1,years_use(y),r,rr);
-          nll(s,stock_season_can_move(s)-1,r,rr) += SCALE(AR1(rho_mu_y), Sigma_MU)(mu_re_y);
+          nll(s,stock_season_can_move(s)-1,r,rr) += dar1_re(mu_re_y, rho_mu_y, Sigma_MU);
         }
         if(mu_model(r,rr) == 8) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
+          matrix<Type> mu_re_ya(n_y,n_ages);
           for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) mu_re_ya(y,a) = mu_re(s,a,stock_season_can_move(s)-1,years_use(y),r,rr);
-          nll(s,stock_season_can_move(s)-1,r,rr) += SCALE(SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)), Sigma_MU)(mu_re_ya); // must be array, not matrix!
+          nll(s,stock_season_can_move(s)-1,r,rr) += d2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
         }
       }
     }
@@ -216,19 +215,19 @@ array<Type> get_nll_mu(array<Type> mu_repars, array<Type> mu_re, matrix<int> mu_
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
           for(int a = 0; a < n_ages; a++) mu_re_a(a) = mu_re(0,a,t,0,r,rr);
-          nll(0,t,r,rr) += SCALE(AR1(rho_mu_a), Sigma_MU)(mu_re_a);
+          nll(0,t,r,rr) += dar1_re(mu_re_a, rho_mu_a, Sigma_MU);
         }
         if(mu_model(r,rr) == 11) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
           for(int y = 0; y< n_y; y++) mu_re_y(y) = mu_re(0,0,t,years_use(y),r,rr);
-          nll(0,t,r,rr) += SCALE(AR1(rho_mu_y), Sigma_MU)(mu_re_y);
+          nll(0,t,r,rr) += dar1_re(mu_re_y, rho_mu_y, Sigma_MU);
         }
         if(mu_model(r,rr) == 12) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
+          matrix<Type> mu_re_ya(n_y,n_ages);
           for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) mu_re_ya(y,a) = mu_re(0,a,t,years_use(y),r,rr);
-          nll(0,t,r,rr) += SCALE(SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)), Sigma_MU)(mu_re_ya); // must be array, not matrix!
+          nll(0,t,r,rr) += d2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
         }
       }
     }
@@ -241,19 +240,19 @@ array<Type> get_nll_mu(array<Type> mu_repars, array<Type> mu_re, matrix<int> mu_
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
           for(int a = 0; a < n_ages; a++) mu_re_a(a) = mu_re(s,a,t,0,r,rr);
-          nll(s,t,r,rr) += SCALE(AR1(rho_mu_a), Sigma_MU)(mu_re_a);
+          nll(s,t,r,rr) += dar1_re(mu_re_a, rho_mu_a, Sigma_MU);
         }
         if(mu_model(r,rr)  == 15) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
           for(int y = 0; y< n_y; y++) mu_re_y(y) = mu_re(s,0,t,years_use(y),r,rr);
-          nll(s,t,r,rr) += SCALE(AR1(rho_mu_y), Sigma_MU)(mu_re_y);
+          nll(s,t,r,rr) += dar1_re(mu_re_y, rho_mu_y, Sigma_MU);
         }
         if(mu_model(r,rr)  == 16) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
+          matrix<Type> mu_re_ya(n_y,n_ages);
           for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) mu_re_ya(y,a) = mu_re(s,a,t,years_use(y),r,rr);
-          nll(s,t,r,rr) += SCALE(SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)), Sigma_MU)(mu_re_ya); // must be array, not matrix!
+          nll(s,t,r,rr) += d2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
         }
       }
     }
@@ -272,7 +271,6 @@ array<Type> simulate_mu_re(array<Type> mu_repars, array<Type> mu_re, matrix<int>
    can_move: n_stocks x n_seasons x n_regions x n_regions 0/1 whether fish can move from one region to another
    years_use: is possibly a subset of years to use for evaluating likelihood (and simulating values). normally = 0,....,n_years_model-1
    */
-  using namespace density; // necessary to use AR1, SCALE, SEPARABLE
   int n_stocks = mu_re.dim(0);
   int n_ages = mu_re.dim(1);
   int n_seasons = mu_re.dim(2);
@@ -299,25 +297,25 @@ array<Type> simulate_mu_re(array<Type> mu_repars, array<Type> mu_re, matrix<int>
       if(mu_model(r,rr) == 2) { //age re
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
         vector<Type> mu_re_a(n_ages);
-        AR1(rho_mu_a).simulate(mu_re_a);
+        mu_re_a = rar1_re(mu_re_a, rho_mu_a, Sigma_MU);
         for(int s = 0; s < n_stocks; s++) for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a) * Sigma_MU;
+          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a);
         }
       }
       if(mu_model(r,rr) == 3) { //year re
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
         vector<Type> mu_re_y(n_y);
-        AR1(rho_mu_y).simulate(mu_re_y);
+        mu_re_y = rar1_re(mu_re_y, rho_mu_y, Sigma_MU);
         for(int s = 0; s < n_stocks; s++) for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y) * Sigma_MU;
+          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y);
         }
       }
       if(mu_model(r,rr) == 4) { //age,year re
         Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-        array<Type> mu_re_ya(n_y,n_ages);
-        SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)).simulate(mu_re_ya);
+        matrix<Type> mu_re_ya(n_y,n_ages);
+        mu_re_ya = r2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
         for(int s = 0; s < n_stocks; s++) for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a) * Sigma_MU;
+          sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a);
         }
       }
     }
@@ -329,25 +327,25 @@ array<Type> simulate_mu_re(array<Type> mu_repars, array<Type> mu_re, matrix<int>
         if(mu_model(r,rr) == 6) { //age re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
-          AR1(rho_mu_a).simulate(mu_re_a);
+          mu_re_a = rar1_re(mu_re_a, rho_mu_a, Sigma_MU);
           for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a);
           }
         }
         if(mu_model(r,rr) == 7) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
-          AR1(rho_mu_y).simulate(mu_re_y);
+          mu_re_y = rar1_re(mu_re_y, rho_mu_y, Sigma_MU);
           for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y);
           }
         }
         if(mu_model(r,rr) == 8) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
-          SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)).simulate(mu_re_ya);
+          matrix<Type> mu_re_ya(n_y,n_ages);
+          mu_re_ya = r2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
           for(int t = 0; t < n_seasons; t++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a);
           }
         }
       }
@@ -360,25 +358,25 @@ array<Type> simulate_mu_re(array<Type> mu_repars, array<Type> mu_re, matrix<int>
         if(mu_model(r,rr) == 10) { //age re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
-          AR1(rho_mu_a).simulate(mu_re_a);
+          mu_re_a = rar1_re(mu_re_a, rho_mu_a, Sigma_MU);
           for(int s = 0; s < n_stocks; s++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) {
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a);
           }
         }
         if(mu_model(r,rr) == 11) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
-          AR1(rho_mu_y).simulate(mu_re_y);
+          mu_re_y = rar1_re(mu_re_y, rho_mu_y, Sigma_MU);
           for(int s = 0; s < n_stocks; s++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++){
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y);
           }
         }
         if(mu_model(r,rr) == 12) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
-          SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)).simulate(mu_re_ya);
+          matrix<Type> mu_re_ya(n_y,n_ages);
+          mu_re_ya = r2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
           for(int s = 0; s < n_stocks; s++) for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++){
-            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a) * Sigma_MU;
+            sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a);
           }
         }
       }
@@ -391,20 +389,20 @@ array<Type> simulate_mu_re(array<Type> mu_repars, array<Type> mu_re, matrix<int>
         if(mu_model(r,rr) ==14) { //age re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_a,2)),-0.5); //marginal sd
           vector<Type> mu_re_a(n_ages);
-          AR1(rho_mu_a).simulate(mu_re_a);
-          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a) * Sigma_MU;
+          mu_re_a = rar1_re(mu_re_a, rho_mu_a, Sigma_MU);
+          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++) sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_a(a);
         }
         if(mu_model(r,rr) ==15) { //year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)),-0.5); //marginal sd
           vector<Type> mu_re_y(n_y);
-          AR1(rho_mu_y).simulate(mu_re_y);
-          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++)  sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y) * Sigma_MU;
+          mu_re_y = rar1_re(mu_re_y, rho_mu_y, Sigma_MU);
+          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++)  sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_y(y);
         }
         if(mu_model(r,rr) ==16) { //age,year re
           Type Sigma_MU = sigma_mu * pow((1-pow(rho_mu_y,2)) * (1-pow(rho_mu_a,2)),-0.5); //marginal sd
-          array<Type> mu_re_ya(n_y,n_ages);
-          SEPARABLE(AR1(rho_mu_a),AR1(rho_mu_y)).simulate(mu_re_ya);
-          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++)  sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a) * Sigma_MU;
+          matrix<Type> mu_re_ya(n_y,n_ages);
+          mu_re_ya = r2dar1_re(mu_re_ya, rho_mu_y, rho_mu_a, Sigma_MU);
+          for(int y = 0; y< n_y; y++) for(int a = 0; a < n_ages; a++)  sim_mu_re(s,a,t,years_use(y),r,rr) = mu_re_ya(y,a);
         }
       }
     }
@@ -498,152 +496,139 @@ array<Type> increment_trans_mu(array<Type> trans_mu_base, Type trend_mu_rate, in
 }
 
 template<class Type>
-Type get_move_devs(array<Type> onto_move, int a, int n_ages, array<Type> onto_move_pars, int s, int r, int rr, array<Type> age_mu_devs) {
+array<Type> get_onto_move_curves(array<Type> onto_move, array<Type> onto_move_pars, array<Type> age_mu_devs, int n_stocks, int n_regions, int n_ages) {
   /*
-   Specify age-specific movement rate
-   onto_move: n_stocks x n_regions x (n_regions - 1), type of age-specific movement
+   Age-specific (ontogenetic) movement curves, evaluated once for each stock, region, and destination
+   onto_move: n_stocks x n_regions x (n_regions - 1), type of age-specific movement. May be empty (no age-specific movement)
    1: increasing logistic; 2: decreasing logistic; 3: double-logistic; 4: double-normal; 5: user-specify
-   a: age
-   n_ages: max age
-   onto_move_pars: n_stocks x n_regions x (n_regions - 1) x n_pars: parameters for age-specific movement
-   s: stock
-   r: source region
-   rr: destination region (excludes diagonal, i.e., r != rr)
-   age_mu_devs: n_stocks x n_regions x (n_regions - 1) x n_ages
+   onto_move_pars: n_stocks x n_regions x (n_regions - 1) x n_pars: parameters for age-specific movement (fixed or estimated)
+   age_mu_devs: n_stocks x n_regions x (n_regions - 1) x n_ages, only used for onto_move = 5
+   n_stocks, n_regions, n_ages: model dimensions
+   returns n_stocks x n_regions x (n_regions - 1) x n_ages, all zero if onto_move is empty
    */
-  
-  Type mu_devs = 0.0;
-  
-  Type onto_move_type = static_cast<Type>(onto_move(s, r, rr));
-  
-  if (onto_move_type == 5 && age_mu_devs.size() == 0) {
-    int n_stocks = onto_move.dim(0);
-    int n_regions = onto_move.dim(1);
-    array<Type> age_mu_devs_tmp(n_stocks, n_regions, n_regions-1, n_ages);
-    age_mu_devs_tmp.setZero();
-    age_mu_devs = age_mu_devs_tmp;
-  }
-  
-  if (onto_move_type == 1) {
-    Type a_max = n_ages - 1;
-    Type a50 = onto_move_pars(s, r, rr, 0);  // Include rr
-    Type k = onto_move_pars(s, r, rr, 1);    // Include rr
-    Type logit_val = 1.0 / (1.0 + exp(-(a - a50) / k));
-    logit_val /= (1.0 / (1.0 + exp(-(a_max - a50) / k)));
-    mu_devs = logit_val;
-  }
-  
-  if (onto_move_type == 2) {
-    Type a50 = onto_move_pars(s, r, rr, 0);
-    Type k = onto_move_pars(s, r, rr, 1);
-    Type logit_val = 1.0 / (1.0 + exp(-(a - a50) / k));
-    logit_val = 1.0 - logit_val;
-    logit_val /= (1.0 - (1.0 / (1.0 + exp(-(0 - a50) / k))));
-    mu_devs = logit_val;
-  }
-  
-  if (onto_move_type == 3) {
-    Type a50_1 = onto_move_pars(s, r, rr, 0);
-    Type k_1 = onto_move_pars(s, r, rr, 1);
-    Type a50_2 = onto_move_pars(s, r, rr, 2);
-    Type k_2 = onto_move_pars(s, r, rr, 3);
-    
-    Type logit_val = 1.0 / (1.0 + exp(-(a - a50_1) / k_1));
-    logit_val *= (1.0 / (1.0 + exp((a - a50_2) / k_2)));
-    
-    Type peak_logit_val = 0.0;
-    
-    for (int test_a = 0; test_a < n_ages; ++test_a) {
-      Type logit_val_tmp = 1.0 / (1.0 + exp(-(test_a - a50_1) / k_1));
-      logit_val_tmp *= (1.0 / (1.0 + exp((test_a - a50_2) / k_2)));
-      if (logit_val_tmp > peak_logit_val) {
-        peak_logit_val = logit_val_tmp;
+  array<Type> curves(n_stocks, n_regions, n_regions-1, n_ages);
+  curves.setZero();
+  if(onto_move.size() == 0) return curves;
+  Type a_max = n_ages - 1;
+  for(int s = 0; s < n_stocks; s++) for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++) {
+    int onto_move_type = (int) asDouble(onto_move(s,r,rr)); //data
+    if((onto_move_type == 1) || (onto_move_type == 2)) {
+      Type a50 = onto_move_pars(s,r,rr,0);
+      Type k = onto_move_pars(s,r,rr,1);
+      Type denom = 1.0 / (1.0 + exp(-(a_max - a50) / k)); //increasing: value at max age
+      if(onto_move_type == 2) denom = 1.0 - 1.0 / (1.0 + exp(-(0 - a50) / k)); //decreasing: value at age 0
+      for(int a = 0; a < n_ages; a++) {
+        Type logit_val = 1.0 / (1.0 + exp(-(Type(a) - a50) / k));
+        if(onto_move_type == 2) logit_val = 1.0 - logit_val;
+        curves(s,r,rr,a) = logit_val / denom;
       }
     }
-    logit_val /= peak_logit_val;
-    mu_devs = logit_val;
-  }
-  
-  if (onto_move_type == 4) {
-    Type a50_1 = onto_move_pars(s, r, rr, 0); 
-    Type k_1 = onto_move_pars(s, r, rr, 1);  
-    Type a50_2 = onto_move_pars(s, r, rr, 2); 
-    Type k_2 = onto_move_pars(s, r, rr, 3);   
-    
-    Type left_val = exp(-pow((a - a50_1) / k_1, 2)); 
-    Type right_val = exp(-pow((a - a50_2) / k_2, 2)); 
-    
-    Type double_normal_val = left_val + right_val;
-    
-    Type peak_left = exp(-pow((a50_1 - a50_1) / k_1, 2));   
-    Type peak_right = exp(-pow((a50_2 - a50_2) / k_2, 2));
-    Type peak_val = peak_left + peak_right;
-    
-    double_normal_val /= peak_val; 
-    mu_devs = double_normal_val;
-  }
-  
-  if (onto_move_type == 5) {
-    mu_devs = age_mu_devs(s, r, rr, a);
+    if(onto_move_type == 3) {
+      Type a50_1 = onto_move_pars(s,r,rr,0);
+      Type k_1 = onto_move_pars(s,r,rr,1);
+      Type a50_2 = onto_move_pars(s,r,rr,2);
+      Type k_2 = onto_move_pars(s,r,rr,3);
+      Type peak_logit_val = 0.0;
+      for(int a = 0; a < n_ages; a++) {
+        curves(s,r,rr,a) = 1.0 / (1.0 + exp(-(Type(a) - a50_1) / k_1));
+        curves(s,r,rr,a) *= 1.0 / (1.0 + exp((Type(a) - a50_2) / k_2));
+        //conditional expression so the peak age is retaped correctly when onto_move_pars are estimated
+        peak_logit_val = CppAD::CondExpGt(curves(s,r,rr,a), peak_logit_val, curves(s,r,rr,a), peak_logit_val);
+      }
+      for(int a = 0; a < n_ages; a++) curves(s,r,rr,a) /= peak_logit_val;
+    }
+    if(onto_move_type == 4) {
+      Type a50_1 = onto_move_pars(s,r,rr,0);
+      Type k_1 = onto_move_pars(s,r,rr,1);
+      Type a50_2 = onto_move_pars(s,r,rr,2);
+      Type k_2 = onto_move_pars(s,r,rr,3);
+      for(int a = 0; a < n_ages; a++) {
+        Type left_val = exp(-pow((Type(a) - a50_1) / k_1, 2));
+        Type right_val = exp(-pow((Type(a) - a50_2) / k_2, 2));
+        curves(s,r,rr,a) = (left_val + right_val) / Type(2); //each normal component peaks at 1
+      }
+    }
+    if((onto_move_type == 5) && age_mu_devs.size()) for(int a = 0; a < n_ages; a++) curves(s,r,rr,a) = age_mu_devs(s,r,rr,a);
   }
-  
-  return mu_devs;
+  return curves;
 }
 
 
+/* 
+  resolve mu_model (0-16) for each region and destination once: 
+    mu_dims(r,rr,0): 0/1 mean or prior-based parameter used (mu_model > 0)
+    mu_dims(r,rr,1): 0/1 parameters differ by stock (stock and stock-season models)
+    mu_dims(r,rr,2): 0/1 parameters differ by season (season and stock-season models)
+    mu_dims(r,rr,3): 0/1 random effects differ by age (mu_model 2, 4, 6, 8, ...)
+    mu_dims(r,rr,4): 0/1 random effects differ by year (mu_model 3, 4, 7, 8, ...)
+    mu_dims(r,rr,5): 0/1 any random effects
+*/
+inline array<int> get_mu_dims(matrix<int> mu_model){
+  int n_regions = mu_model.rows();
+  array<int> mu_dims(n_regions, n_regions-1, 6);
+  mu_dims.setZero();
+  for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++){
+    int m = mu_model(r,rr);
+    if((m > 0) && (m <= 16)){
+      int group = (m-1)/4, re_type = m % 4; //group: 0 constant, 1 stock, 2 season, 3 stock-season. re_type: 1 none, 2 age, 3 year, 0 age and year
+      mu_dims(r,rr,0) = 1;
+      mu_dims(r,rr,1) = (group == 1) || (group == 3);
+      mu_dims(r,rr,2) = group >= 2;
+      mu_dims(r,rr,3) = (re_type == 2) || (re_type == 0);
+      mu_dims(r,rr,4) = (re_type == 3) || (re_type == 0);
+      mu_dims(r,rr,5) = re_type != 1;
+    }
+  }
+  return mu_dims;
+}
+
 template<class Type>
-array<Type> get_trans_mu_base(array<Type> trans_mu, array<Type> mu_re, array<Type> mu_prior_re, array<int> use_mu_prior,
-                              matrix<int> mu_model, array<Type> Ecov_lm, array<int> Ecov_how,
-                              array<Type> onto_move, array<Type> onto_move_pars, array<Type> age_mu_devs,
-                              vector<int> mig_type, int apply_mu_trend, Type trend_mu_rate) {
+array<Type> get_trans_mu_base(array<Type>& trans_mu, array<Type>& mu_re, array<Type>& mu_prior_re, array<int>& use_mu_prior,
+                              const matrix<int>& mu_model, array<Type>& Ecov_lm, array<int>& Ecov_how,
+                              array<Type>& onto_move, array<Type>& onto_move_curves,
+                              const vector<int>& mig_type, int apply_mu_trend, Type trend_mu_rate) {
   
   int n_stocks = mu_re.dim(0);
   int n_ages = mu_re.dim(1);
   int n_seasons = mu_re.dim(2);
   int ny = mu_re.dim(3);
   int n_regions = mu_re.dim(4);
+  int n_Ecov = Ecov_how.dim(0);
   
   array<Type> trans_mu_base(n_stocks, n_ages, n_seasons, ny, n_regions, n_regions-1);
   trans_mu_base.setZero();
   
   if (n_regions > 1) {
-    for (int s = 0; s < n_stocks; s++) for (int a = 0; a < n_ages; a++) for (int t = 0; t < n_seasons; t++) {
-      for (int y = 0; y < ny; y++) for (int r = 0; r < n_regions; r++) {
-              
-              if (onto_move.size() == 0) {
-                for (int rr = 0; rr < n_regions - 1; rr++) {
-                  if ((mu_model(r,rr) > 0) && (mu_model(r,rr) <= 4)) {  // Constant models
-                    if (mu_model(r,rr) == 2) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,0,0,r,rr);
-                    if (mu_model(r,rr) == 3) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,0,0,y,r,rr);
-                    if (mu_model(r,rr) == 4) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,0,y,r,rr);
-                    if (use_mu_prior(0,0,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(0,0,r,rr);
-                    else trans_mu_base(s,a,t,y,r,rr) += trans_mu(s,t,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 4) && (mu_model(r,rr) <= 8)) {  // Stock models
-                    if (mu_model(r,rr) == 6) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,0,0,r,rr);
-                    if (mu_model(r,rr) == 7) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,0,0,y,r,rr);
-                    if (mu_model(r,rr) == 8) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,0,y,r,rr);
-                    if (use_mu_prior(s,0,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s,0,r,rr);
-                    else trans_mu_base(s,a,t,y,r,rr) += trans_mu(s,t,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 8) && (mu_model(r,rr) <= 12)) {  // Season models
-                    if (mu_model(r,rr) == 10) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,t,0,r,rr);
-                    if (mu_model(r,rr) == 11) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,0,t,y,r,rr);
-                    if (mu_model(r,rr) == 12) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,t,y,r,rr);
-                    if (use_mu_prior(0,t,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(0,t,r,rr);
-                    else trans_mu_base(s,a,t,y,r,rr) += trans_mu(s,t,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 12) && (mu_model(r,rr) <= 16)) {  // Stock-season models
-                    if (mu_model(r,rr) == 14) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,t,0,r,rr);
-                    if (mu_model(r,rr) == 15) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,0,t,y,r,rr);
-                    if (mu_model(r,rr) == 16) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,t,y,r,rr);
-                    if (use_mu_prior(s,t,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s,t,r,rr);
-                    else trans_mu_base(s,a,t,y,r,rr) += trans_mu(s,t,r,rr);
-                  }
-                  
-                  for(int i=0; i < Ecov_how.dim(0); i++) if(Ecov_how(i,s,a,t,r,rr) == 1) trans_mu_base(s,a,t,y,r,rr) += Ecov_lm(s,a,t,r,rr,y,i); //will be 0 if not used
-                }
-              } else {
+    array<int> mu_dims = get_mu_dims(mu_model);
+    if (onto_move.size() == 0) {
+      //additive on the transformed scale, so each distinct rate is calculated once and copied to all ages and years that share it
+      for (int s = 0; s < n_stocks; s++) for (int t = 0; t < n_seasons; t++) for (int r = 0; r < n_regions; r++) for (int rr = 0; rr < n_regions - 1; rr++) {
+        int s_p = mu_dims(r,rr,1) ? s : 0, t_p = mu_dims(r,rr,2) ? t : 0;
+        int Ecov_st = 0;
+        for(int a = 0; a < n_ages; a++) for(int i = 0; i < n_Ecov; i++) if(Ecov_how(i,s,a,t,r,rr) == 1) Ecov_st = 1;
+        for (int a = 0; a < n_ages; a++) {
+          int Ecov_a = 0;
+          for(int i = 0; i < n_Ecov; i++) if(Ecov_how(i,s,a,t,r,rr) == 1) Ecov_a = 1;
+          int a_src = (mu_dims(r,rr,3) || Ecov_st) ? a : 0;
+          int by_y = mu_dims(r,rr,4) || Ecov_a;
+          for (int y = 0; y < ny; y++) {
+            int y_src = by_y ? y : 0;
+            if((a_src != a) || (y_src != y)) {
+              trans_mu_base(s,a,t,y,r,rr) = trans_mu_base(s,a_src,t,y_src,r,rr);
+              continue;
+            }
+            if (mu_dims(r,rr,0)) {
+              if (mu_dims(r,rr,5)) trans_mu_base(s,a,t,y,r,rr) += mu_re(s_p, mu_dims(r,rr,3) ? a : 0, t_p, mu_dims(r,rr,4) ? y : 0, r, rr);
+              if (use_mu_prior(s_p,t_p,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s_p,t_p,r,rr);
+              else trans_mu_base(s,a,t,y,r,rr) += trans_mu(s,t,r,rr);
+            }
+            for(int i=0; i < n_Ecov; i++) if(Ecov_how(i,s,a,t,r,rr) == 1) trans_mu_base(s,a,t,y,r,rr) += Ecov_lm(s,a,t,r,rr,y,i); //will be 0 if not used
+          }
+        }
+      }
+    } else {
+      for (int s = 0; s < n_stocks; s++) for (int a = 0; a < n_ages; a++) for (int t = 0; t < n_seasons; t++) {
+        for (int y = 0; y < ny; y++) for (int r = 0; r < n_regions; r++) {
                 
                 if (mig_type(s) == 0) { // sequential movement
                   // Step 1: Compute trans_mu_base before transforming
@@ -659,8 +644,7 @@ array<Type> get_trans_mu_base(array<Type> trans_mu, array<Type> mu_re, array<Typ
                     trans_mu_base(s,a,t,y,r,rr) /= denom;
                     
                     // Add ontogenetic movement deviations
-                    Type move_devs = get_move_devs(onto_move, a, n_ages, onto_move_pars, s, r, rr, age_mu_devs);
-                    trans_mu_base(s,a,t,y,r,rr) += move_devs;
+                    trans_mu_base(s,a,t,y,r,rr) += onto_move_curves(s,r,rr,a);
                   }
                   
                   // Step 2: Convert all values for r to logistic-normal scale
@@ -677,40 +661,20 @@ array<Type> get_trans_mu_base(array<Type> trans_mu, array<Type> mu_re, array<Typ
                 
                 if (mig_type(s) == 1) { // simultaneous movement
                   for (int rr = 0; rr < n_regions - 1; rr++) {
-                    Type move_devs = get_move_devs(onto_move, a, n_ages, onto_move_pars, s, r, rr, age_mu_devs);
-                    trans_mu_base(s,a,t,y,r,rr) = log(exp(trans_mu(s,t,r,rr))+move_devs); // Need to double check!
+                    trans_mu_base(s,a,t,y,r,rr) = log(exp(trans_mu(s,t,r,rr))+onto_move_curves(s,r,rr,a)); // Need to double check!
                   }
                 }
                 
                 for (int rr = 0; rr < n_regions - 1; rr++) {
-                  if ((mu_model(r,rr) > 0) && (mu_model(r,rr) <= 4)) {  // Constant models
-                    if (mu_model(r,rr) == 2) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,0,0,r,rr);
-                    if (mu_model(r,rr) == 3) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,0,0,y,r,rr);
-                    if (mu_model(r,rr) == 4) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,0,y,r,rr);
-                    if (use_mu_prior(0,0,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(0,0,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 4) && (mu_model(r,rr) <= 8)) {  // Stock models
-                    if (mu_model(r,rr) == 6) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,0,0,r,rr);
-                    if (mu_model(r,rr) == 7) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,0,0,y,r,rr);
-                    if (mu_model(r,rr) == 8) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,0,y,r,rr);
-                    if (use_mu_prior(s,0,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s,0,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 8) && (mu_model(r,rr) <= 12)) {  // Season models
-                    if (mu_model(r,rr) == 10) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,t,0,r,rr);
-                    if (mu_model(r,rr) == 11) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,0,t,y,r,rr);
-                    if (mu_model(r,rr) == 12) trans_mu_base(s,a,t,y,r,rr) += mu_re(0,a,t,y,r,rr);
-                    if (use_mu_prior(0,t,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(0,t,r,rr);
-                  }
-                  if ((mu_model(r,rr) > 12) && (mu_model(r,rr) <= 16)) {  // Stock-season models
-                    if (mu_model(r,rr) == 14) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,t,0,r,rr);
-                    if (mu_model(r,rr) == 15) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,0,t,y,r,rr);
-                    if (mu_model(r,rr) == 16) trans_mu_base(s,a,t,y,r,rr) += mu_re(s,a,t,y,r,rr);
-                    if (use_mu_prior(s,t,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s,t,r,rr);
+                  if (mu_dims(r,rr,0)) {
+                    int s_p = mu_dims(r,rr,1) ? s : 0, t_p = mu_dims(r,rr,2) ? t : 0;
+                    if (mu_dims(r,rr,5)) trans_mu_base(s,a,t,y,r,rr) += mu_re(s_p, mu_dims(r,rr,3) ? a : 0, t_p, mu_dims(r,rr,4) ? y : 0, r, rr);
+                    if (use_mu_prior(s_p,t_p,r,rr)) trans_mu_base(s,a,t,y,r,rr) += mu_prior_re(s_p,t_p,r,rr);
                   }
                   
-                  for(int i=0; i < Ecov_how.dim(0); i++) if(Ecov_how(i,s,a,t,r,rr) == 1) trans_mu_base(s,a,t,y,r,rr) += Ecov_lm(s,a,t,r,rr,y,i); //will be 0 if not used
+                  for(int i=0; i < n_Ecov; i++) if(Ecov_how(i,s,a,t,r,rr) == 1) trans_mu_base(s,a,t,y,r,rr) += Ecov_lm(s,a,t,r,rr,y,i); //will be 0 if not used
                 }
-              }
+        }
       }
     }
     if(apply_mu_trend) trans_mu_base = increment_trans_mu(trans_mu_base, trend_mu_rate, n_ages, n_seasons, ny, n_stocks, n_regions);
@@ -1047,7 +1011,7 @@ array<Type> get_trans_mu_base(array<Type> trans_mu, array<Type> mu_re, array<Typ
 
 
 template <class Type>
-matrix<Type> get_mu_matrix(int stock, int age, int season, int year, vector<int> mig_type, array<int> can_move, array<int> must_move, array<Type> trans_mu_base){
+matrix<Type> get_mu_matrix(int stock, int age, int season, int year, const vector<int>& mig_type, array<int>& can_move, array<int>& must_move, array<Type>& trans_mu_base){
   /* 
    Construct n_regions x n_regions movement matrix
    stock: which stock
@@ -1092,8 +1056,8 @@ matrix<Type> get_mu_matrix(int stock, int age, int season, int year, vector<int>
 //done
 
 template <class Type>
-array<Type> get_avg_mu(array<Type> trans_mu_base, vector<int> years, vector<int> mig_type, array<int> can_move,
-                       array<int> must_move){
+array<Type> get_avg_mu(array<Type>& trans_mu_base, const vector<int>& years, const vector<int>& mig_type, array<int>& can_move,
+                       array<int>& must_move){
   /* 
    Construct n_stocks x n_ages x n_seasons x n_regions x n_regions array of "averaged" movement parameters over years
    stock: which stock
@@ -1154,10 +1118,41 @@ array<Type> get_avg_mu(array<Type> trans_mu_base, vector<int> years, vector<int>
   return avg_mu;
 }
 
+template <class Type>
+array<int> get_mu_by_age_year(int n_stocks, int n_seasons, matrix<int> mu_model, array<int> Ecov_how, array<Type> onto_move, int apply_mu_trend){
+  /* 
+   0/1 flags (n_stocks x n_seasons x 2) for whether any movement parameter of trans_mu_base (from get_trans_mu_base) can differ among ages (0)
+   or years (1) given the configuration. Movement matrices are then only calculated for distinct ages and years.
+   mu_model: n_regions x n_regions-1. see definitions at top of move.hpp.
+   Ecov_how: n_Ecov x n_stocks x n_ages x n_seasons x n_regions x n_regions-1: 0/1 values indicating to use effects on migration.
+   onto_move: n_stocks x n_regions x (n_regions - 1): 0/1 determining whether age-specific movement rate is used
+   apply_mu_trend: 0/1 whether a trend over years is added to trans_mu_base
+   */
+  int n_regions = mu_model.rows();
+  array<int> mu_by(n_stocks, n_seasons, 2);
+  mu_by.setZero();
+  if(n_regions > 1){
+    array<int> mu_dims = get_mu_dims(mu_model);
+    for(int s = 0; s < n_stocks; s++) for(int t = 0; t < n_seasons; t++) {
+      if(onto_move.size()) mu_by(s,t,0) = 1;
+      if(apply_mu_trend) mu_by(s,t,1) = 1;
+      for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++) {
+        if(mu_dims(r,rr,3)) mu_by(s,t,0) = 1;
+        if(mu_dims(r,rr,4)) mu_by(s,t,1) = 1;
+        for(int i = 0; i < Ecov_how.dim(0); i++) for(int a = 0; a < Ecov_how.dim(2); a++) if(Ecov_how(i,s,a,t,r,rr) == 1) {
+          mu_by(s,t,0) = 1;
+          mu_by(s,t,1) = 1;
+        }
+      }
+    }
+  }
+  return mu_by;
+}
+
 //all movement matrices
 template <class Type>
-array<Type> get_mu(array<Type> trans_mu_base, array<int> can_move,  array<int> must_move, vector<int> mig_type, 
-                   int n_years_proj, int n_years_model, int proj_mu_opt, vector<int> avg_years){
+array<Type> get_mu(array<Type>& trans_mu_base, array<int>& can_move,  array<int>& must_move, const vector<int>& mig_type, 
+                   int n_years_proj, int n_years_model, int proj_mu_opt, const vector<int>& avg_years, array<int>& mu_by){
   /* 
    Construct n_stocks x n_ages x n_seasons x n_years x n_regions x n_regions array of movement matrices
    trans_mu_base: n_stocks x n_ages x n_seasons x n_years x n_regions x n_regions-1. array retruned by get_trans_mu_base
@@ -1168,6 +1163,7 @@ array<Type> get_mu(array<Type> trans_mu_base, array<int> can_move,  array<int> m
    n_years_model: number of years before projections
    proj_mu_opt: 1: use averega of mu over years, 2: use random trans_mu_base with RE and/or Ecov effects in projection years
    avg_years: which model years to use for averaging mu
+   mu_by: n_stocks x n_seasons x 2. 0/1 whether trans_mu_base differs by age and year (from get_mu_by_age_year)
    */
   int n_stocks = trans_mu_base.dim(0);
   int n_ages = trans_mu_base.dim(1);
@@ -1178,6 +1174,11 @@ array<Type> get_mu(array<Type> trans_mu_base, array<int> can_move,  array<int> m
   mu.setZero();
   if(n_regions>1) {
     for(int s = 0; s< n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int t = 0; t < n_seasons; t++) for(int y = 0; y < n_y; y++){
+      int a_src = mu_by(s,t,0) ? a : 0, y_src = mu_by(s,t,1) ? y : 0;
+      if((a_src != a) || (y_src != y)) { //same movement matrix as an age and year already calculated
+        for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++) mu(s,a,t,y,r,rr) = mu(s,a_src,t,y_src,r,rr);
+        continue;
+      }
       matrix<Type> mu_y = get_mu_matrix(s,a,t,y,mig_type,can_move,must_move,trans_mu_base);
       for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++) mu(s,a,t,y,r,rr) = mu_y(r,rr);
     }
@@ -1191,14 +1192,7 @@ array<Type> get_mu(array<Type> trans_mu_base, array<int> can_move,  array<int> m
             mu(s,a,t,y,r,rr) = mu_avg(s,a,t,r,rr);
           }
         }
-      } else { // proj_mu_opt == 1, use mu_re and/or ecov_lm in projection years
-        for(int s = 0; s< n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int t = 0; t < n_seasons; t++){ 
-          for(int y = n_years_model; y < n_y; y++){
-            matrix<Type> mu_y = get_mu_matrix(s,a,t,y,mig_type,can_move,must_move,trans_mu_base);
-            for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++) mu(s,a,t,y,r,rr) = mu_y(r,rr);
-          }
-        }
-      }
+      } // proj_mu_opt == 1, mu_re and/or ecov_lm in projection years are already used above
     }
   }
   return(mu);
@@ -1207,7 +1201,7 @@ array<Type> get_mu(array<Type> trans_mu_base, array<int> can_move,  array<int> m
 
 //extract array of mu parameters for a given year
 template <class Type>
-array<Type> get_mu_y(int y, array<Type> mu){
+array<Type> get_mu_y(int y, array<Type>& mu){
   int n_stocks = mu.dim(0);
   int n_ages = mu.dim(1);
   int n_seasons = mu.dim(2);
@@ -80,8 +80,15 @@ Type objective_function<Type>::operator() ()
   DATA_IARRAY(n_poly_Ecov_M); // dim = n_ecov x n_stocks x n_ages x n_regions, order of orthogonal polynomial to use for effect of each covariate on each stock
   DATA_IARRAY(n_poly_Ecov_mu); // dim = n_ecov x n_stocks x n_ages x n_seasons x n_regions x (n_regions-1), order of orthogonal polynomial to use for effect of each covariate on each stock
   DATA_IMATRIX(n_poly_Ecov_q); // dim = n_ecov x n_indices, order of orthogonal polynomial to use for effect of each covariate on each index
+  DATA_IVECTOR(Ecov_poly_fixed); // n_Ecov: 0/1 use fixed orthogonal polynomial coefficients (from the observations) for polynomial effects
+  DATA_MATRIX(Ecov_poly_alpha); // n_Ecov x max(n_poly): fixed orthogonal polynomial coefficients, attr(poly(), "coefs")$alpha
+  DATA_MATRIX(Ecov_poly_norm2); // n_Ecov x max(n_poly)+2: fixed orthogonal polynomial coefficients, attr(poly(), "coefs")$norm2
+  DATA_IMATRIX(Ecov_links_M); // n_links x 4 (Ecov, stock, age, region): active Ecov effects on M (Ecov_how_M == 1)
+  DATA_IMATRIX(Ecov_links_q); // n_links x 2 (Ecov, index): active Ecov effects on q (Ecov_how_q == 1)
+  DATA_IMATRIX(Ecov_links_mu); // n_links x 6 (Ecov, stock, age, season, region, destination): active Ecov effects on movement (Ecov_how_mu == 1)
   
   DATA_IVECTOR(Ecov_use_re); // n_Ecov: 0/1: use Ecov_re? If yes, add to nll.
+  DATA_IVECTOR(Ecov_marginalize); // n_Ecov: 0/1: integrate latent Ecov by Kalman filter instead of Ecov_re? If yes, Ecov_x is the smoothed Ecov.
 
   DATA_VECTOR(q_lower); //length = n_indices
   DATA_VECTOR(q_upper); //length = n_indices
@@ -106,6 +113,9 @@ Type objective_function<Type>::operator() ()
   DATA_INTEGER(decouple_recruitment); //0: keep recruitment and abundance at age correlation, 1: recruitment is independent of RE for older NAA
   DATA_IVECTOR(N1_model); //n_stocks, 0: just age-specific numbers at age, 1: 2 pars: log_N_{1,1}, log_F0, age-structure defined by equilibrium NAA calculations, 2: AR1 random effect
   DATA_IVECTOR(NAA_re_model); //n_stocks, 0 SCAA, 1 "rec", 2 "rec+1"
+  DATA_IARRAY(NAA_cor_units); //n_stocks x n_regions, 0 = independent, otherwise unit index of joint GMRF for "rec+1" NAA deviations
+  DATA_IVECTOR(NAA_rec_cor_units); //n_stocks, 0 = independent, otherwise unit index of joint GMRF for recruitment deviations ("rec" or decoupled)
+  DATA_INTEGER(NAA_re_screen); //0/1: linearized screening likelihood instead of recruitment random effects (1 stock, 1 region, NAA_re_model = 1)
   DATA_IARRAY(NAA_where); //n_stocks x n_regions x n_ages: 0/1 whether NAA exists in region at beginning of year. Also controls inclusion of any RE in nll.
   DATA_IMATRIX(n_M_re); // n_stocks x n_regions how many time-varying RE each year? n_ages? 1? n_est_M? max(n_M_re) <= n_ages)
   DATA_IARRAY(M_re_index); // n_stocks x n_regions x n_ages, indicators of which M_re to use for which age. length(unique(M_re_index[s,r,])) == n_M_re[s,r]
@@ -122,7 +132,6 @@ Type objective_function<Type>::operator() ()
   
   // Ontogenetic Movement 
   DATA_ARRAY(onto_move); // n_stocks x n_regions x (n_regions - 1): 0/1 determining whether age-specific movement rate is used
-  DATA_ARRAY(onto_move_pars); // n_stocks x n_regions x (n_regions - 1) x n_pars (= 4): parameters for age-specific movement
   DATA_ARRAY(age_mu_devs); // n_stocks x n_regions x (n_regions - 1) x n_ages: only used when user specified age-specific movement 
   
   DATA_INTEGER(apply_re_trend); // trend on random effects
@@ -185,13 +194,20 @@ Type objective_function<Type>::operator() ()
   DATA_INTEGER(do_post_samp_sel); //whether to ADREPORT posterior residuals for selectivity re. 
   DATA_INTEGER(do_post_samp_Ecov); //whether to ADREPORT posterior residuals for Ecov re. 
   DATA_INTEGER(do_post_samp_q); //whether to ADREPORT posterior residuals for q re. 
+  DATA_INTEGER(report_level); //0 = minimal, 1 = standard, 2 = full: which large arrays (PTMs, all_NAA, Ecov_out/Ecov_lm, movement) to REPORT
+  DATA_IVECTOR(adreport_groups); //(6) 0/1 whether to ADREPORT each group of derived quantities: core SSB/F, NAA, FAA detail, BRPs, movement, Ecov
+  DATA_INTEGER(do_NAA_det); //0/1: REPORT the deterministic NAA trajectory (NAA_det) used by warm_start_re. Set by fit_wham when fit.tmb.control$warm.start.re = TRUE.
+  DATA_IVECTOR(re_free); //(5) 0/1 whether any random effects or their parameters are estimated for M, movement, selectivity, q, Ecov. If 0, their nll (and Ecov_x) are constants evaluated in double. Set by get_re_free before MakeADFun.
   int sum_do_post_samp = do_post_samp_N + do_post_samp_M + do_post_samp_mu + do_post_samp_sel + do_post_samp_Ecov + do_post_samp_q;
   //reference points
   DATA_INTEGER(do_SPR_BRPs); //whether to calculate and adreport reference points. 
   DATA_INTEGER(do_MSY_BRPs); //whether to calculate and adreport reference points. 
+  DATA_INTEGER(do_sdrep_BRPs); //0/1: is this the TMB::sdreport tape? Reference points are only ADREPORTed (and taped) if so. Set by sdreport_wham.
+  DATA_INTEGER(do_eq_curves); //whether to calculate and report equilibrium SSB/R, Y/R, SSB, and yield at each F in eq_curves_F using static (avg_years_ind) inputs. Only used if do_SPR_BRPs = 1.
+  DATA_VECTOR(eq_curves_F); //values of fully-selected F for equilibrium curves
   DATA_INTEGER(SPR_weight_type); //0 = use average recruitment for each stock for weighting, 1= use SPR_weights 
   DATA_VECTOR(SPR_weights); //n_stocks; weights to use for to sum stock-specific SPRs for aggregate reference point. should sum to 1.
-  DATA_SCALAR(percentSPR); // percentage to use for SPR-based reference points. Default = 40.
+  DATA_VECTOR(percentSPR); // percentage(s) to use for SPR-based reference points. Default = 40. The first is used for projections and the primary BRPs, all are solved together.
   DATA_INTEGER(XSPR_R_opt); //1(3): use annual R estimates(predictions) for annual SSB_XSPR, 2(4): use average R estimates(predictions). 5: use bias-corrected expected recruitment. See XSPR_R_avg_yrs for years to average over.
   DATA_IVECTOR(XSPR_R_avg_yrs); // model year indices (TMB, starts @ 0) to use for averaging recruitment when defining SSB_XSPR (if XSPR_R_opt = 2,4)
   DATA_VECTOR(FXSPR_init); // annual initial values to use for newton steps to find FXSPR (n_years_model+n_proj_years)
@@ -203,7 +219,7 @@ Type objective_function<Type>::operator() ()
   DATA_SCALAR(FMSY_static_init); // initial value to use for newton steps to find FXSPR_static
   DATA_INTEGER(which_F_age_static); // which age,fleet of F to use for full total F for static brps (max of average FAA_tot over avg_years_ind)
   
-  DATA_INTEGER(use_alt_AR1) //0: use density namespace, 1: use ar1 or 2dar1 calculated by "hand" for nll and simulation.
+  DATA_INTEGER(use_alt_AR1) //0: use sparse precision densities in ar1_re.hpp, 1: use ar1 or 2dar1 calculated by "hand" (conditional) for nll and simulation.
   
   // data for projections
   DATA_INTEGER(n_years_proj); // number of years to project  
@@ -223,7 +239,7 @@ Type objective_function<Type>::operator() ()
   DATA_VECTOR(logR_sd); //  (n_stocks) empirical sd recruitment in model years, used for SCAA recruit projections
   DATA_VECTOR(F_proj_init); // annual initial values  to use for newton steps to find F for use in projections  (n_years_proj)
   DATA_SCALAR(percentFMSY); // percent of FMSY to use for calculating catch in projections.
-  DATA_SCALAR(percentFXSPR); // percent of F_XSPR to use for calculating catch in projections. For example, GOM cod uses F = 75% F_40%SPR, so percentFXSPR = 75 and percentSPR = 40. Default = 100.
+  DATA_VECTOR(percentFXSPR); // percent of F_XSPR to use for calculating catch in projections. For example, GOM cod uses F = 75% F_40%SPR, so percentFXSPR = 75 and percentSPR = 40. Default = 100. length 1 or length(percentSPR).
   
 
   // parameters - general
@@ -237,11 +253,14 @@ Type objective_function<Type>::operator() ()
   PARAMETER_ARRAY(trans_mu); //n_stocks x n_seasons x n_regions x n_regions-1 (mean) migration parameters
   PARAMETER_ARRAY(mu_re); //n_stocks x n_ages x n_seasons x n_y x n_regions x n_regions-1 RE for migration
   PARAMETER_ARRAY(mu_repars); //n_stocks x n_seasons x n_regions x n_regions-1 x 3 (sig, rho_a, rho_y)
+  PARAMETER_ARRAY(onto_move_pars); // n_stocks x n_regions x (n_regions - 1) x n_pars (= 4): parameters for age-specific movement (usually fixed)
   //N1 might need some tweaking. for example, if all fish are forced to be in spawning region at the beginning of the year, then there should be no N1 in other regions.
   PARAMETER_ARRAY(N1_repars); // (n_stocks x n_regions x 3) mean, sig, rho
   PARAMETER_ARRAY(log_N1); // (n_stocks x n_regions x n_ages)
   PARAMETER_ARRAY(log_NAA_sigma); // (n_stocks x n_regions x n_ages) sigmas for NAA RE
   PARAMETER_ARRAY(trans_NAA_rho); // (n_stocks x n_regions x 3) rho_a, rho_y, recruits rho_y
+  PARAMETER_VECTOR(NAA_units_cor); // (n_u*(n_u-1)/2) unstructured correlation among units in NAA_cor_units
+  PARAMETER_VECTOR(NAA_rec_units_cor); // (n_u*(n_u-1)/2) unstructured correlation among units in NAA_rec_cor_units
   //Just have annual NAA currently
   PARAMETER_ARRAY(log_NAA); //(n_stocks x n_regions x nyears-1 x n_ages) 
   
@@ -300,11 +319,34 @@ Type objective_function<Type>::operator() ()
   // Environmental covariate process model --------------------------------------
 
   // 'true' estimated Ecov (x_t in Miller et al. 2016 CJFAS)
-  matrix<Type> Ecov_x = get_Ecov(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re);
+  matrix<Type> Ecov_x;
+  if(re_free(4)) Ecov_x = get_Ecov(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re);
+  else Ecov_x = get_Ecov(Ecov_model, fixed_as_double(Ecov_process_pars), fixed_as_double(Ecov_re), Ecov_use_re).template cast<Type>();
   if(Ecov_model.sum()>0) {
-    matrix<Type> nll_Ecov = get_nll_Ecov(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re, years_use_Ecov);
+    vector<int> Ecov_use_re_nll = Ecov_use_re; //Ecov_re are not used for Ecovs integrated by the Kalman filter
+    for(int i = 0; i < n_Ecov; i++) if(Ecov_marginalize(i) == 1) Ecov_use_re_nll(i) = 0;
+    matrix<Type> nll_Ecov;
+    if(re_free(4)) nll_Ecov = get_nll_Ecov(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re_nll, years_use_Ecov);
+    else nll_Ecov = get_nll_Ecov(Ecov_model, fixed_as_double(Ecov_process_pars), fixed_as_double(Ecov_re), Ecov_use_re_nll, 
+      years_use_Ecov).template cast<Type>();
     nll += nll_Ecov.sum();
     REPORT(nll_Ecov);
+    if(Ecov_marginalize.sum()>0){
+      array<Type> Ecov_kf = get_Ecov_kf(Ecov_model, Ecov_process_pars, Ecov_marginalize, Ecov_obs, Ecov_use_obs, Ecov_obs_logsigma, 
+        years_use_Ecov, Ecov_x.rows());
+      matrix<Type> nll_Ecov_kf(Ecov_x.rows(), n_Ecov);
+      matrix<Type> Ecov_x_var(Ecov_x.rows(), n_Ecov);
+      nll_Ecov_kf.setZero();
+      Ecov_x_var.setZero();
+      for(int i = 0; i < n_Ecov; i++) if(Ecov_marginalize(i) == 1) for(int y = 0; y < Ecov_x.rows(); y++) {
+        nll_Ecov_kf(y,i) = Ecov_kf(y,i,0);
+        Ecov_x(y,i) = Ecov_kf(y,i,1);
+        Ecov_x_var(y,i) = Ecov_kf(y,i,2);
+      }
+      nll += nll_Ecov_kf.sum();
+      REPORT(nll_Ecov_kf);
+      REPORT(Ecov_x_var);
+    }
     SIMULATE if(do_simulate_Ecov_re == 1){
       Ecov_re = simulate_Ecov_re(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re, years_use_Ecov);
       Ecov_x = get_Ecov(Ecov_model, Ecov_process_pars, Ecov_re, Ecov_use_re);
@@ -339,9 +381,11 @@ Type objective_function<Type>::operator() ()
         Ecov_obs_sigma(y,i) = exp(Ecov_obs_logsigma(y,i));
       }
       if(Ecov_use_obs(y,i) == 1){
-        nll_Ecov_obs(y,i) -= keep(keep_E(y,i)) * dnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i), 1);
-        nll_Ecov_obs(y,i) -= keep.cdf_lower(keep_E(y,i)) * log(squeeze(pnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i))));
-        nll_Ecov_obs(y,i) -= keep.cdf_upper(keep_E(y,i)) * log(1.0 - squeeze(pnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i))));
+        if(Ecov_marginalize(i) == 0){ //otherwise already in nll_Ecov_kf
+          nll_Ecov_obs(y,i) -= keep(keep_E(y,i)) * dnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i), 1);
+          nll_Ecov_obs(y,i) -= keep.cdf_lower(keep_E(y,i)) * log(squeeze(pnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i))));
+          nll_Ecov_obs(y,i) -= keep.cdf_upper(keep_E(y,i)) * log(1.0 - squeeze(pnorm(obsvec(keep_E(y,i)), Ecov_x(y,i), Ecov_obs_sigma(y,i))));
+        }
         SIMULATE if(do_simulate_data(2)) {
           Ecov_obs(y,i) = rnorm(Ecov_x(y,i), Ecov_obs_sigma(y,i));
           obsvec(keep_E(y,i)) = Ecov_obs(y,i);
@@ -360,7 +404,7 @@ Type objective_function<Type>::operator() ()
   }
   if(Ecov_model.sum() > 0){
     matrix<Type> Ecov_resid = Ecov_obs.array() - Ecov_x.block(0,0,n_years_Ecov,n_Ecov).array();
-    if(sum_do_post_samp == 0){
+    if((sum_do_post_samp == 0) & (adreport_groups(5) == 1)){
       ADREPORT(Ecov_x);
       ADREPORT(Ecov_resid);
     }
@@ -374,163 +418,124 @@ Type objective_function<Type>::operator() ()
   /////////////////////////////////////////////////////////
   // Lag environmental covariates -------------------------------------
   // Then use Ecov_out_*(t) for processes in year t, instead of Ecov_x
+  // Each unique lagged (and polynomial transformed) Ecov column is computed once and shared by all effects (see Ecov_lm_cache)
+  Ecov_lm_cache<Type> Ecov_cache(Ecov_x, n_years_model, n_years_proj, proj_Ecov_opt, avg_years_Ecov, Ecov_use_proj, 
+    Ecov_poly_fixed, Ecov_poly_alpha, Ecov_poly_norm2);
   //Recruit
   array<Type> Ecov_lm_R(n_stocks, n_years_pop, n_Ecov); 
   Ecov_lm_R.setZero();
-  array<Type> Ecov_out_R(n_stocks, n_years_pop, n_Ecov);
-  Ecov_out_R.setZero();
   if(Ecov_how_R.sum()>0){
-    for(int s = 0; s < n_stocks; s++){
-      vector<int> t_ind_s = ind_Ecov_out_start_R.col(s);
-      vector<int> t_ind_e = ind_Ecov_out_end_R.col(s);
-      //see(t_ind_s);
-      //see(t_ind_e);
-      matrix<Type> tmp = get_Ecov_out(Ecov_x, n_years_model, n_years_proj, t_ind_s, t_ind_e, proj_Ecov_opt, avg_years_Ecov, Ecov_use_proj);
-      //see(tmp);
-      for(int j = 0; j < tmp.rows(); j++) for(int k = 0; k < n_Ecov; k++) Ecov_out_R(s,j,k) = tmp(j,k);
-    }
-    REPORT(Ecov_out_R); 
-    //see(Ecov_out_R);
     int max_n_poly_R = Ecov_beta_R.dim(2); // now a 3D array dim: (n_stocks,n_Ecov,max(n_poly_Ecov_R))
-    //see(max_n_poly_R);
     for(int s = 0; s < n_stocks; s++) {
+      vector<int> t_ind_s = ind_Ecov_out_start_R.col(s);
+      vector<int> t_ind_e = ind_Ecov_out_end_R.col(s);
+      vector<int> n_poly_Ecov_R_s = n_poly_Ecov_R.col(s);
       matrix<Type> Ecov_beta_R_s(n_Ecov,max_n_poly_R);
-      matrix<Type> Ecov_out_R_s(n_years_pop,n_Ecov);
-      vector<int> n_poly_Ecov_R_s(n_Ecov);
-      Ecov_beta_R_s.setZero();
-      for(int i = 0; i <n_Ecov; i++) {
-        n_poly_Ecov_R_s(i) = n_poly_Ecov_R(i,s);
-        //see(n_poly_Ecov_R_s(i));
-        //see(n_years_pop);
-        //see(Ecov_out_R.dim);
-        //see(Ecov_beta_R_s);
-        for(int y = 0; y < n_years_pop; y++) Ecov_out_R_s(y,i) = Ecov_out_R(s,y,i);
-        //see("here");
-        for(int j = 0; j < max_n_poly_R; j++) Ecov_beta_R_s(i,j) = Ecov_beta_R(s,i,j);
-      }
-      //see(n_poly_Ecov_R_s);
-      //see(Ecov_beta_R_s);
-      //see(Ecov_out_R_s);
-      //see("after");
-      matrix<Type> Ecov_lm_R_s = get_Ecov_lm(Ecov_beta_R_s,Ecov_out_R_s, n_years_model, n_years_proj, n_poly_Ecov_R_s);
+      for(int i = 0; i <n_Ecov; i++) for(int j = 0; j < max_n_poly_R; j++) Ecov_beta_R_s(i,j) = Ecov_beta_R(s,i,j);
+      matrix<Type> Ecov_lm_R_s = Ecov_cache.get_lm(Ecov_beta_R_s, t_ind_s, t_ind_e, n_poly_Ecov_R_s);
       for(int y = 0; y < n_years_pop; y++) for(int i = 0; i <n_Ecov; i++) Ecov_lm_R(s,y,i) = Ecov_lm_R_s(y,i);
     }
-    //see(Ecov_lm_R)
-    REPORT(Ecov_lm_R);
+    if((report_level > 0) & isDouble<Type>::value) { //REPORT only, not taped
+      array<Type> Ecov_out_R(n_stocks, n_years_pop, n_Ecov);
+      for(int s = 0; s < n_stocks; s++) {
+        vector<int> t_ind_s = ind_Ecov_out_start_R.col(s);
+        vector<int> t_ind_e = ind_Ecov_out_end_R.col(s);
+        matrix<Type> tmp = Ecov_cache.get_out(t_ind_s, t_ind_e);
+        for(int j = 0; j < tmp.rows(); j++) for(int k = 0; k < n_Ecov; k++) Ecov_out_R(s,j,k) = tmp(j,k);
+      }
+      REPORT(Ecov_out_R);
+      REPORT(Ecov_lm_R);
+    }
   }
   ///////////////////////
 
   //M
-  array<Type> Ecov_out_M(n_stocks, n_ages, n_regions, n_years_pop, n_Ecov);
-  Ecov_out_M.setZero();
   array<Type> Ecov_lm_M(n_stocks, n_regions, n_ages, n_years_pop, n_Ecov); 
   Ecov_lm_M.setZero();
   if(Ecov_how_M.sum()>0){
-    for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++){
-      vector<int> t_ind_s(n_Ecov), t_ind_e(n_Ecov);
-      for(int i = 0; i < n_Ecov; i++){
-        t_ind_s(i) = ind_Ecov_out_start_M(i,s,a,r);
-        t_ind_e(i) = ind_Ecov_out_end_M(i,s,a,r);
-      }
-      matrix<Type> tmp = get_Ecov_out(Ecov_x, n_years_model, n_years_proj, t_ind_s, t_ind_e, proj_Ecov_opt, avg_years_Ecov, Ecov_use_proj);
-      for(int j = 0; j < tmp.rows(); j++) for(int i = 0; i < n_Ecov; i++) Ecov_out_M(s,a,r,j,i) = tmp(j,i);
+    for(int k = 0; k < Ecov_links_M.rows(); k++){ //only active effects
+      int i = Ecov_links_M(k,0)-1, s = Ecov_links_M(k,1)-1, a = Ecov_links_M(k,2)-1, r = Ecov_links_M(k,3)-1;
+      vector<Type> beta(n_poly_Ecov_M(i,s,a,r));
+      for(int j = 0; j < beta.size(); j++) beta(j) = Ecov_beta_M(s,a,r,i,j);
+      vector<Type> lm = Ecov_cache.get_lm_i(i, ind_Ecov_out_start_M(i,s,a,r), ind_Ecov_out_end_M(i,s,a,r), beta);
+      for(int y = 0; y < n_years_pop; y++) Ecov_lm_M(s,r,a,y,i) = lm(y);
     }
-    REPORT(Ecov_out_M);
-    int max_n_poly_M = Ecov_beta_M.dim(4); // now a 5D array dim: (n_stocks, n_ages, n_regions, n_Ecov, max(n_poly_Ecov_M))
-    for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++){
-      matrix<Type> Ecov_beta_M_s_r_a(n_Ecov,max_n_poly_M);
-      matrix<Type> Ecov_out_M_s_r_a(n_years_pop, n_Ecov);
-      vector<int> n_poly_Ecov_M_s_r_a(n_Ecov);
-      for(int i = 0; i <n_Ecov; i++) {
-        n_poly_Ecov_M_s_r_a(i) = n_poly_Ecov_M(i,s,a,r);
-        for(int y = 0; y < n_years_pop; y++) Ecov_out_M_s_r_a(y,i) = Ecov_out_M(s,a,r,y,i);
-        for(int j = 0; j < max_n_poly_M; j++) Ecov_beta_M_s_r_a(i,j) = Ecov_beta_M(s,a,r,i,j);
+    if((report_level > 1) & isDouble<Type>::value) {
+      array<Type> Ecov_out_M(n_stocks, n_ages, n_regions, n_years_pop, n_Ecov);
+      for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int r = 0; r < n_regions; r++){
+        vector<int> t_ind_s(n_Ecov), t_ind_e(n_Ecov);
+        for(int i = 0; i < n_Ecov; i++){
+          t_ind_s(i) = ind_Ecov_out_start_M(i,s,a,r);
+          t_ind_e(i) = ind_Ecov_out_end_M(i,s,a,r);
+        }
+        matrix<Type> tmp = Ecov_cache.get_out(t_ind_s, t_ind_e);
+        for(int j = 0; j < tmp.rows(); j++) for(int i = 0; i < n_Ecov; i++) Ecov_out_M(s,a,r,j,i) = tmp(j,i);
       }
-      matrix<Type> Ecov_lm_M_s_r_a = get_Ecov_lm(Ecov_beta_M_s_r_a,Ecov_out_M_s_r_a, n_years_model, n_years_proj, n_poly_Ecov_M_s_r_a);
-      for(int y = 0; y < n_years_pop; y++) for(int i = 0; i <n_Ecov; i++) Ecov_lm_M(s,r,a,y,i) = Ecov_lm_M_s_r_a(y,i);
+      REPORT(Ecov_out_M);
+      REPORT(Ecov_lm_M);
     }
-    REPORT(Ecov_lm_M);
   }
   
   //q
-  array<Type> Ecov_out_q(n_indices, n_years_pop, n_Ecov);
-  Ecov_out_q.setZero();
   array<Type> Ecov_lm_q(n_indices,n_years_pop, n_Ecov); 
   Ecov_lm_q.setZero();
   if(Ecov_how_q.sum()>0){
-    for(int i = 0; i < n_indices; i++){
-      vector<int> t_ind_s = ind_Ecov_out_start_q.col(i);
-      vector<int> t_ind_e = ind_Ecov_out_end_q.col(i);
-      matrix<Type> tmp = get_Ecov_out(Ecov_x,n_years_model, n_years_proj, t_ind_s, t_ind_e, proj_Ecov_opt, avg_years_Ecov, Ecov_use_proj);
-      for(int j = 0; j < tmp.rows(); j++) for(int k = 0; k < n_Ecov; k++) Ecov_out_q(i,j,k) = tmp(j,k);
+    for(int k = 0; k < Ecov_links_q.rows(); k++){ //only active effects
+      int j = Ecov_links_q(k,0)-1, i = Ecov_links_q(k,1)-1;
+      vector<Type> beta(n_poly_Ecov_q(j,i));
+      for(int p = 0; p < beta.size(); p++) beta(p) = Ecov_beta_q(i,j,p);
+      vector<Type> lm = Ecov_cache.get_lm_i(j, ind_Ecov_out_start_q(j,i), ind_Ecov_out_end_q(j,i), beta);
+      for(int y = 0; y < n_years_pop; y++) Ecov_lm_q(i,y,j) = lm(y);
     }
-    //see("q");
-    REPORT(Ecov_out_q);
-    int max_n_poly_q = Ecov_beta_q.dim(2); // now a 3D array dim: (n_indices, n_Ecov, n_poly)
-    //see(Ecov_lm_q.dim);
-    //see(Ecov_out_q.dim);
-    //see(n_years_pop);
-    for(int i = 0; i < n_indices; i++){
-    //see("q1");
-      matrix<Type> Ecov_beta_q_i(n_Ecov,max_n_poly_q);
-      matrix<Type> Ecov_out_q_i(n_years_pop, n_Ecov);
-      vector<int> n_poly_Ecov_q_i(n_Ecov);
-      for(int k = 0; k <n_Ecov; k++) {
-        n_poly_Ecov_q_i(k) = n_poly_Ecov_q(k,i); 
-        for(int y = 0; y < n_years_pop; y++) Ecov_out_q_i(y,k) = Ecov_out_q(i,y,k);
-        for(int j = 0; j < max_n_poly_q; j++) Ecov_beta_q_i(k,j) = Ecov_beta_q(i,k,j);
+    if((report_level > 0) & isDouble<Type>::value) {
+      array<Type> Ecov_out_q(n_indices, n_years_pop, n_Ecov);
+      for(int i = 0; i < n_indices; i++){
+        vector<int> t_ind_s = ind_Ecov_out_start_q.col(i);
+        vector<int> t_ind_e = ind_Ecov_out_end_q.col(i);
+        matrix<Type> tmp = Ecov_cache.get_out(t_ind_s, t_ind_e);
+        for(int j = 0; j < tmp.rows(); j++) for(int k = 0; k < n_Ecov; k++) Ecov_out_q(i,j,k) = tmp(j,k);
       }
-      //see("q2");
-      //see(n_poly_Ecov_q_i);
-
-      matrix<Type> Ecov_lm_q_i = get_Ecov_lm(Ecov_beta_q_i,Ecov_out_q_i, n_years_model, n_years_proj, n_poly_Ecov_q_i);
-      //see(Ecov_lm_q_i.rows());
-      //see(Ecov_lm_q_i.cols());
-      //see("q3");
-      //see(Ecov_lm_q_i);
-      for(int y = 0; y < n_years_pop; y++) for(int k = 0; k < n_Ecov; k++) Ecov_lm_q(i,y,k) = Ecov_lm_q_i(y,k);
-      //see("q4");
+      REPORT(Ecov_out_q);
+      REPORT(Ecov_lm_q);
     }
-    REPORT(Ecov_lm_q);
   }
   
   //mu
-  array<Type> Ecov_out_mu(n_stocks, n_ages, n_seasons, n_regions, n_regions-1, n_years_pop, n_Ecov);
-  Ecov_out_mu.setZero();
   array<Type> Ecov_lm_mu(n_stocks, n_ages, n_seasons, n_regions, n_regions-1, n_years_pop, n_Ecov);
   Ecov_lm_mu.setZero();
   if(Ecov_how_mu.sum()>0){
-    for(int s = 0; s < n_stocks; s++)  for(int a = 0; a < n_ages; a++) for(int t = 0; t < n_seasons; t++) for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++){
-      vector<int> t_ind_s(n_Ecov), t_ind_e(n_Ecov);
-      for(int i = 0; i < n_Ecov; i++) {
-        t_ind_s(i) = ind_Ecov_out_start_mu(i,s,a,t,r,rr);
-        t_ind_e(i) = ind_Ecov_out_end_mu(i,s,a,t,r,rr);
-      }
-      matrix<Type> tmp = get_Ecov_out(Ecov_x, n_years_model, n_years_proj, t_ind_s, t_ind_e, proj_Ecov_opt, avg_years_Ecov, Ecov_use_proj);
-      for(int j = 0; j < tmp.rows(); j++) for(int i = 0; i < n_Ecov; i++) Ecov_out_mu(s,a,t,r,rr,j,i) = tmp(j,i);
+    for(int k = 0; k < Ecov_links_mu.rows(); k++){ //only active effects
+      int i = Ecov_links_mu(k,0)-1, s = Ecov_links_mu(k,1)-1, a = Ecov_links_mu(k,2)-1, t = Ecov_links_mu(k,3)-1;
+      int r = Ecov_links_mu(k,4)-1, rr = Ecov_links_mu(k,5)-1;
+      vector<Type> beta(n_poly_Ecov_mu(i,s,a,t,r,rr));
+      for(int j = 0; j < beta.size(); j++) beta(j) = Ecov_beta_mu(s,a,t,r,rr,i,j);
+      vector<Type> lm = Ecov_cache.get_lm_i(i, ind_Ecov_out_start_mu(i,s,a,t,r,rr), ind_Ecov_out_end_mu(i,s,a,t,r,rr), beta);
+      for(int y = 0; y < n_years_pop; y++) Ecov_lm_mu(s,a,t,r,rr,y,i) = lm(y);
     }
-    REPORT(Ecov_out_mu);
-    int max_n_poly_mu = Ecov_beta_mu.dim(6); // a 7D array dim: (n_stocks, n_ages, n_seasons, n_regions, n_regions-1, n_Ecov, max(n_poly))
-    for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int t = 0; t < n_seasons; t++) for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++){
-      matrix<Type> Ecov_beta_mu_s_a_t_r_rr(n_Ecov,max_n_poly_mu);
-      matrix<Type> Ecov_out_mu_s_a_t_r_rr(n_years_pop, n_Ecov);
-      vector<int> n_poly_Ecov_mu_s_a_t_r_rr(n_Ecov);
-      for(int i = 0; i <n_Ecov; i++) {
-        n_poly_Ecov_mu_s_a_t_r_rr(i) = n_poly_Ecov_mu(i,s,a,t,r,rr);
-        for(int y = 0; y < n_years_pop; y++) Ecov_out_mu_s_a_t_r_rr(y,i) = Ecov_out_mu(s,a,t,r,rr,y,i);
-        for(int j = 0; j <max_n_poly_mu; j++) Ecov_beta_mu_s_a_t_r_rr(i,j) = Ecov_beta_mu(s,a,t,r,rr,i,j);
+    if((report_level > 1) & isDouble<Type>::value) {
+      array<Type> Ecov_out_mu(n_stocks, n_ages, n_seasons, n_regions, n_regions-1, n_years_pop, n_Ecov);
+      for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int t = 0; t < n_seasons; t++) for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions-1; rr++){
+        vector<int> t_ind_s(n_Ecov), t_ind_e(n_Ecov);
+        for(int i = 0; i < n_Ecov; i++) {
+          t_ind_s(i) = ind_Ecov_out_start_mu(i,s,a,t,r,rr);
+          t_ind_e(i) = ind_Ecov_out_end_mu(i,s,a,t,r,rr);
+        }
+        matrix<Type> tmp = Ecov_cache.get_out(t_ind_s, t_ind_e);
+        for(int j = 0; j < tmp.rows(); j++) for(int i = 0; i < n_Ecov; i++) Ecov_out_mu(s,a,t,r,rr,j,i) = tmp(j,i);
       }
-      matrix<Type> Ecov_lm_s_a_t_r_rr = get_Ecov_lm(Ecov_beta_mu_s_a_t_r_rr,Ecov_out_mu_s_a_t_r_rr, n_years_model, n_years_proj, n_poly_Ecov_mu_s_a_t_r_rr);
-      for(int y = 0; y < n_years_pop; y++) for(int i = 0; i <n_Ecov; i++) Ecov_lm_mu(s,a,t,r,rr,y,i) = Ecov_lm_s_a_t_r_rr(y,i);
+      REPORT(Ecov_out_mu);
+      REPORT(Ecov_lm_mu);
     }
-    REPORT(Ecov_lm_mu);
   }
   /////////////////////////////////////////
   
   /////////////////////////////////////////
   // Selectivity --------------------------------------------------------------
   if(selblock_models_re.sum()>0) {
-    vector<Type> nll_sel = get_nll_sel(selblock_models_re, n_years_selblocks, n_selpars_est, selpars_re, sel_repars);
+    vector<Type> nll_sel;
+    if(re_free(2)) nll_sel = get_nll_sel(selblock_models_re, n_years_selblocks, n_selpars_est, selpars_re, sel_repars);
+    else nll_sel = get_nll_sel(selblock_models_re, n_years_selblocks, n_selpars_est, fixed_as_double(selpars_re), 
+      fixed_as_double(sel_repars)).template cast<Type>();
     nll += nll_sel.sum();
     REPORT(nll_sel);
     SIMULATE if(do_simulate_sel_re){
@@ -544,10 +549,10 @@ Type objective_function<Type>::operator() ()
   REPORT(selpars_re_mats); //can't report a vector<array<Type>> ?
 
   vector<matrix<Type> > selpars = get_selpars(selblock_models, n_selpars, logit_selpars, 
-    selpars_re_mats, selpars_lower, selpars_upper, n_years_model);
+    selpars_re_mats, selpars_lower, selpars_upper, n_years_model, selblock_years, selblock_models_re);
   REPORT(selpars);
 
-  vector<matrix<Type> > selAA = get_selAA(n_years_model, n_ages, n_selblocks, selpars, selblock_models);
+  vector<matrix<Type> > selAA = get_selAA(n_years_model, n_ages, n_selblocks, selpars, selblock_models, selblock_years, selblock_models_re);
   REPORT(selAA);
   /////////////////////////////////////////
  
@@ -579,7 +584,9 @@ Type objective_function<Type>::operator() ()
     }
   }
   if(use_q_re.sum()>0) {
-    matrix<Type> nll_q_re = get_nll_q_re(q_repars, q_re, use_q_re, years_use);
+    matrix<Type> nll_q_re;
+    if(re_free(3)) nll_q_re = get_nll_q_re(q_repars, q_re, use_q_re, years_use);
+    else nll_q_re = get_nll_q_re(fixed_as_double(q_repars), fixed_as_double(q_re), use_q_re, years_use).template cast<Type>();
     nll += nll_q_re.sum();
     REPORT(nll_q_re);
     SIMULATE if(do_simulate_q_re ==1){
@@ -605,7 +612,9 @@ Type objective_function<Type>::operator() ()
   /////////////////////////////////////////
   //natural mortality 
   //RE and log_M (possibly updated in time steps)
-  matrix<Type> nll_M = get_nll_M(M_repars, M_re_model, M_model, M_re, n_M_re, years_use);
+  matrix<Type> nll_M;
+  if(re_free(0)) nll_M = get_nll_M(M_repars, M_re_model, M_model, M_re, n_M_re, years_use);
+  else nll_M = get_nll_M(fixed_as_double(M_repars), M_re_model, M_model, fixed_as_double(M_re), n_M_re, years_use).template cast<Type>();
   nll += nll_M.sum();
   REPORT(nll_M);
   SIMULATE if(do_simulate_M_re){
@@ -629,6 +638,8 @@ Type objective_function<Type>::operator() ()
   //n_stocks x n_regions x n_years x n_ages
   array<Type> log_M = get_log_M(M_re, M_re_index, M_model, n_years_model, Mpars, log_b, waa, waa_pointer_M, Ecov_lm_M, Ecov_how_M, n_years_proj, 
     proj_M_opt, avg_years_ind);
+  //0/1 whether log_M differs by year for each stock and region
+  matrix<int> M_by_year = get_M_by_year(M_re_model, M_model, waa, waa_pointer_M, Ecov_how_M);
   array<Type> MAA = get_MAA(log_M);
   REPORT(log_M);
   REPORT(MAA);
@@ -668,7 +679,9 @@ Type objective_function<Type>::operator() ()
     }
     //if((mu_model != 1) & (mu_model != 5) & (mu_model != 9) & (mu_model != 13)){ //some type of random effects
     //see(11.2);
-    array<Type> nll_mu_re = get_nll_mu(mu_repars, mu_re, mu_model, can_move, years_use);
+    array<Type> nll_mu_re;
+    if(re_free(1)) nll_mu_re = get_nll_mu(mu_repars, mu_re, mu_model, can_move, years_use);
+    else nll_mu_re = double_as_Type<Type>(get_nll_mu(fixed_as_double(mu_repars), fixed_as_double(mu_re), mu_model, can_move, years_use));
     nll += nll_mu_re.sum();
     REPORT(nll_mu_re);
     SIMULATE if(do_simulate_mu_re){
@@ -678,15 +691,20 @@ Type objective_function<Type>::operator() ()
     if(do_post_samp_mu) ADREPORT(mu_re);
   }
     
+  //age-specific movement curves (n_stocks x n_regions x n_regions-1 x n_ages), evaluated once
+  array<Type> onto_move_curves = get_onto_move_curves(onto_move, onto_move_pars, age_mu_devs, n_stocks, n_regions, n_ages);
+  if(onto_move.size()) REPORT(onto_move_curves);
   array<Type> trans_mu_base = get_trans_mu_base(trans_mu, mu_re, mu_prior_re, use_mu_prior, 
                                                 mu_model, Ecov_lm_mu, Ecov_how_mu, 
-                                                onto_move, onto_move_pars, age_mu_devs,
+                                                onto_move, onto_move_curves,
                                                 mig_type, apply_mu_trend, trend_mu_rate);
-  REPORT(trans_mu_base);
+  if(report_level > 1) REPORT(trans_mu_base);
   //n_stocks x n_ages x n_seasons x n_years_pop x n_regions x n_regions - 1
   //rows sum to 1 for mig_type = 0 (prob move), rows sum to 0 for mig_type 1 (instantaneous)
-  array<Type> mu = get_mu(trans_mu_base, can_move, must_move, mig_type, n_years_proj, n_years_model, proj_mu_opt, avg_years_ind);
-  REPORT(mu);
+  //0/1 whether movement differs by age and year for each stock and season
+  array<int> mu_by_age_year = get_mu_by_age_year(n_stocks, n_seasons, mu_model, Ecov_how_mu, onto_move, apply_mu_trend);
+  array<Type> mu = get_mu(trans_mu_base, can_move, must_move, mig_type, n_years_proj, n_years_model, proj_mu_opt, avg_years_ind, mu_by_age_year);
+  if(report_level > 0) REPORT(mu);
   /////////////////////////////////////////
 
   /////////////////////////////////////////
@@ -704,10 +722,12 @@ Type objective_function<Type>::operator() ()
   
   //get probability transition matrices for yearly survival, movement, capture...
   array<Type> annual_Ps = get_annual_Ps(n_years_model, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, FAA, log_M, mu, L);
-  //seasonal PTMs for last year, just for inspection
-  array<Type> seasonal_Ps_terminal_year = get_seasonal_Ps_y(n_years_model-1,fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
-    FAA, log_M, mu, L);
-  REPORT(seasonal_Ps_terminal_year);
+  //seasonal PTMs for last year, just for inspection. REPORT only, not taped
+  if((report_level > 1) & isDouble<Type>::value){
+    array<Type> seasonal_Ps_terminal_year = get_seasonal_Ps_y(n_years_model-1,fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
+      FAA, log_M, mu, L);
+    REPORT(seasonal_Ps_terminal_year);
+  }
   //just survival categories for spawning
   array<Type> annual_SAA_spawn = get_annual_SAA_spawn(n_years_model, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, fracyr_SSB, 
     spawn_seasons, FAA, log_M, mu, L); 
@@ -762,10 +782,19 @@ Type objective_function<Type>::operator() ()
   //should work for SCAA and RE models
   array<Type> all_NAA = get_all_NAA(NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
    mature_all, waa_ssb, recruit_model, mean_rec_pars, log_SR_a, log_SR_b, 
-   Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model,0, move_dyn); //log_NAA should be mapped accordingly to exclude NAA=0 e.g., recruitment by region.
-  array<Type> all_NAA_1 = all_NAA;
-  REPORT(all_NAA_1);
+   Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model,0, move_dyn, NAA_re_screen); //log_NAA should be mapped accordingly to exclude NAA=0 e.g., recruitment by region.
+  if(report_level > 1){
+    array<Type> all_NAA_1 = all_NAA;
+    REPORT(all_NAA_1);
+  }
   array<Type> NAA = extract_NAA(all_NAA);
+  if(do_NAA_det & isDouble<Type>::value){ //not taped. Deterministic NAA trajectory under current fixed effects, used by warm_start_re to initialize log_NAA
+    array<Type> all_NAA_det = get_all_NAA(NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where,
+      mature_all, waa_ssb, recruit_model, mean_rec_pars, log_SR_a, log_SR_b,
+      Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model,0, move_dyn, 1);
+    array<Type> NAA_det = extract_NAA(all_NAA_det);
+    REPORT(NAA_det);
+  }
   //This will use get_all_NAA, get_SSB, and get_pred_NAA to form devs and calculate likelihoods
   array<Type> marg_NAA_sigma = get_marginal_NAA_sigma(log_NAA_sigma, trans_NAA_rho, NAA_re_model, decouple_recruitment);
   REPORT(marg_NAA_sigma);
@@ -805,7 +834,7 @@ Type objective_function<Type>::operator() ()
       // see("yproj");
       // see(y);
       // see(annual_Ps.dim);
-      all_NAA = update_all_NAA(y, all_NAA, NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
+      update_all_NAA(y, all_NAA, NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
         mature_all, waa_ssb, recruit_model, mean_rec_pars, log_SR_a, log_SR_b, 
         Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model, logR_proj, proj_R_opt, R_XSPR, bias_correct_pe, 
         marg_NAA_sigma, trace, move_dyn);
@@ -813,19 +842,21 @@ Type objective_function<Type>::operator() ()
       NAA = extract_NAA(all_NAA);
       R_XSPR = get_RXSPR(all_NAA, spawn_regions, n_years_model, n_years_proj, XSPR_R_opt, XSPR_R_avg_yrs, marg_NAA_sigma);
       //There are many options for defining F in projection years so a lot of inputs
-      FAA = update_FAA_proj(y, proj_F_opt, FAA, NAA, log_M, mu, L, mat_y, waa_ssb_y, waa_catch_y, fleet_regions, fleet_seasons, 
+      update_FAA_proj(y, proj_F_opt, FAA, NAA, log_M, mu, L, mat_y, waa_ssb_y, waa_catch_y, fleet_regions, fleet_seasons, 
         fracyr_ssb_y, spawn_regions, can_move, must_move, mig_type, avg_years_ind, n_years_model, which_F_age, fracyr_seasons, 
-            n_regions_is_small, percentSPR, proj_Fcatch, percentFXSPR, percentFMSY, R_XSPR,
+            n_regions_is_small, percentSPR(0), proj_Fcatch, percentFXSPR(0), percentFMSY, R_XSPR,
         FXSPR_init, FMSY_init, F_proj_init, log_SR_a, log_SR_b, spawn_seasons, recruit_model, SPR_weights, SPR_weight_type, bias_correct_brps, 
         marg_NAA_sigma, trace);
         // if(trace) see(y);
         // if(trace) for(int a = 0; a < n_ages; a++) see(FAA(0,y,a));
-      annual_Ps = update_annual_Ps(y, annual_Ps, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, FAA, log_M, mu, L);
-      annual_SAA_spawn = update_annual_SAA_spawn(y, annual_SAA_spawn, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
+      update_annual_Ps(y, annual_Ps, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, FAA, log_M, mu, L);
+      update_annual_SAA_spawn(y, annual_SAA_spawn, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
         fracyr_SSB_all, spawn_seasons, FAA, log_M, mu, L);
     }
-    array<Type> all_NAA_2 = all_NAA;
-    REPORT(all_NAA_2);
+    if(report_level > 1){
+      array<Type> all_NAA_2 = all_NAA;
+      REPORT(all_NAA_2);
+    }
     //if(trace) std::exit(EXIT_FAILURE);
   }
 
@@ -849,10 +880,11 @@ Type objective_function<Type>::operator() ()
     SIMULATE if(do_simulate_N_re) REPORT(logR_proj);
   }
  
-  matrix<Type> nll_NAA = get_NAA_nll(NAA_re_model, all_NAA, log_NAA_sigma, trans_NAA_rho, NAA_where, spawn_regions, years_use, bias_correct_pe, decouple_recruitment,
-    use_alt_AR1);
-  nll += nll_NAA.sum();
+  matrix<Type> nll_NAA = get_NAA_nll(NAA_re_model, all_NAA, log_NAA_sigma, trans_NAA_rho, NAA_where, spawn_regions, years_use, 
+    NAA_cor_units, NAA_units_cor, NAA_rec_cor_units, NAA_rec_units_cor, bias_correct_pe, decouple_recruitment, use_alt_AR1);
+  if(NAA_re_screen == 0) nll += nll_NAA.sum(); //otherwise in nll_NAA_screen
   //see(nll);
+  //n_stocks x n_regions. For units joined by NAA_cor_units or NAA_rec_cor_units, the rho of the first unit is used and the whole joint nll is in its cell
   REPORT(nll_NAA);
 
   SIMULATE if(do_simulate_N_re){
@@ -863,7 +895,7 @@ Type objective_function<Type>::operator() ()
       sim_alt_AR1 = 1;
     }
     array<Type> NAA_devs_sim = simulate_NAA_devs(NAA_devs, NAA_re_model, log_NAA_sigma, trans_NAA_rho, NAA_where, spawn_regions, years_use, 
-      bias_correct_pe, decouple_recruitment, sim_alt_AR1, ystart);
+      NAA_cor_units, NAA_units_cor, NAA_rec_cor_units, NAA_rec_units_cor, bias_correct_pe, decouple_recruitment, sim_alt_AR1, ystart);
     array<Type> NAA_devs_2 = NAA_devs_sim;
     REPORT(NAA_devs_2);
     //repopulate log_NAA, NAA, pred_NAA, SSB,etc.
@@ -874,15 +906,17 @@ Type objective_function<Type>::operator() ()
       Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model,trace, move_dyn);
     R_XSPR = get_RXSPR(all_NAA, spawn_regions, n_years_model, n_years_proj, XSPR_R_opt, XSPR_R_avg_yrs, marg_NAA_sigma);
     
-    array<Type> all_NAA_3 = all_NAA;
-    REPORT(all_NAA_3);
+    if(report_level > 1){
+      array<Type> all_NAA_3 = all_NAA;
+      REPORT(all_NAA_3);
+    }
 
     if(n_years_proj > 0){
 
       for(int y = n_years_model; y < n_years_pop; y++){
         log_NAA = get_simulated_log_NAA(N1_model, N1, N1_repars, NAA_re_model, NAA_devs_sim, log_NAA, NAA_where, recruit_model, mean_rec_pars,
           log_SR_a, log_SR_b, Ecov_how_R, Ecov_lm_R, spawn_regions, annual_Ps, annual_SAA_spawn, waa_ssb, mature_all, n_years_model, logR_proj, move_dyn);
-        all_NAA = update_all_NAA(y, all_NAA, NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
+        update_all_NAA(y, all_NAA, NAA_re_model, N1_model, N1, N1_repars, log_NAA, NAA_where, 
           mature_all, waa_ssb, recruit_model, mean_rec_pars, log_SR_a, log_SR_b, 
           Ecov_how_R, Ecov_lm_R, spawn_regions,  annual_Ps, annual_SAA_spawn, n_years_model, logR_proj, proj_R_opt, R_XSPR, bias_correct_pe, 
           marg_NAA_sigma, trace, move_dyn);
@@ -890,17 +924,19 @@ Type objective_function<Type>::operator() ()
         R_XSPR = get_RXSPR(all_NAA, spawn_regions, n_years_model, n_years_proj, XSPR_R_opt, XSPR_R_avg_yrs, marg_NAA_sigma);
         NAA = extract_NAA(all_NAA);
         //There are many options for defining F in projection years so a lot of inputs
-        FAA = update_FAA_proj(y, proj_F_opt, FAA, NAA, log_M, mu, L, mat_y, waa_ssb_y, waa_catch_y, fleet_regions, fleet_seasons, 
+        update_FAA_proj(y, proj_F_opt, FAA, NAA, log_M, mu, L, mat_y, waa_ssb_y, waa_catch_y, fleet_regions, fleet_seasons, 
           fracyr_ssb_y, spawn_regions, can_move, must_move, mig_type, avg_years_ind, n_years_model, which_F_age, fracyr_seasons, 
-          n_regions_is_small, percentSPR, proj_Fcatch, percentFXSPR, percentFMSY, R_XSPR, FXSPR_init, FMSY_init, F_proj_init, 
+          n_regions_is_small, percentSPR(0), proj_Fcatch, percentFXSPR(0), percentFMSY, R_XSPR, FXSPR_init, FMSY_init, F_proj_init, 
           log_SR_a, log_SR_b, spawn_seasons, recruit_model, SPR_weights, SPR_weight_type, bias_correct_brps, 
           marg_NAA_sigma, trace);
-        annual_Ps = update_annual_Ps(y, annual_Ps, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, FAA, log_M, mu, L);
-        annual_SAA_spawn = update_annual_SAA_spawn(y, annual_SAA_spawn, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
+        update_annual_Ps(y, annual_Ps, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, FAA, log_M, mu, L);
+        update_annual_SAA_spawn(y, annual_SAA_spawn, fleet_regions, fleet_seasons, can_move, mig_type, fracyr_seasons, 
           fracyr_SSB_all, spawn_seasons, FAA, log_M, mu, L);
       }
-      array<Type> all_NAA_4 = all_NAA;
-      REPORT(all_NAA_4);
+      if(report_level > 1){
+        array<Type> all_NAA_4 = all_NAA;
+        REPORT(all_NAA_4);
+      }
     }
 
     NAA = extract_NAA(all_NAA);
@@ -916,10 +952,12 @@ Type objective_function<Type>::operator() ()
   //matrix<Type> F(n_years_pop,n_fleets); //n_years_pop x n_fleets (projection years not yet populated)
   //for(int f = 0; f < log_F.cols(); f++) F.col(f) = exp(vector<Type> (log_F.col(f)));
   // see(F);
-  REPORT(annual_Ps);
-  REPORT(annual_SAA_spawn);
+  if(report_level > 1){
+    REPORT(annual_Ps);
+    REPORT(annual_SAA_spawn);
+    REPORT(all_NAA);
+  }
   //REPORT(F);
-  REPORT(all_NAA);
   // REPORT(log_F);
   REPORT(NAA);
   REPORT(pred_NAA);
@@ -957,7 +995,7 @@ Type objective_function<Type>::operator() ()
   
   matrix<Type> nll_agg_catch = get_nll_agg_catch(pred_log_catch, agg_catch_sigma, log_catch_sig_scale, obsvec,
     use_agg_catch, keep_C, keep);
-  nll += nll_agg_catch.sum();
+  if(NAA_re_screen == 0) nll += nll_agg_catch.sum(); //otherwise in nll_NAA_screen
   //see(nll);
   REPORT(nll_agg_catch);
   SIMULATE if(do_simulate_data(0)){
@@ -970,8 +1008,10 @@ Type objective_function<Type>::operator() ()
     catch_Neff, age_comp_model_fleets, catch_paa_pars, keep_Cpaa, keep, obsvec, agesvec, do_osa);
   nll += nll_catch_acomp.sum();
   REPORT(nll_catch_acomp);
-  matrix<Type> catch_Neff_out = get_Neff_out(catch_Neff, age_comp_model_fleets, catch_paa_pars);
-  REPORT(catch_Neff_out);
+  if(isDouble<Type>::value){ //REPORT only, not taped
+    matrix<Type> catch_Neff_out = get_Neff_out(catch_Neff, age_comp_model_fleets, catch_paa_pars);
+    REPORT(catch_Neff_out);
+  }
   //see(nll);
   SIMULATE if(do_simulate_data(0)){
     obsvec = simulate_catch_paa_in_obsvec(obsvec, agesvec, pred_catch_paa, use_catch_paa,  keep_Cpaa, catch_Neff, 
@@ -999,9 +1039,16 @@ Type objective_function<Type>::operator() ()
 
   matrix<Type> nll_agg_indices = get_nll_agg_indices(pred_log_indices, agg_index_sigma, log_index_sig_scale, obsvec,
     use_indices, keep_I, keep);
-  nll += nll_agg_indices.sum();
+  if(NAA_re_screen == 0) nll += nll_agg_indices.sum(); //otherwise in nll_NAA_screen
   //see(nll);
   REPORT(nll_agg_indices);
+  if(NAA_re_screen == 1){
+    Type nll_NAA_screen = get_NAA_screen_nll(NAA, annual_Ps, NAA_where, log_NAA_sigma, trans_NAA_rho, pred_CAA, waa_catch, agg_catch, 
+      use_agg_catch, pred_log_catch, agg_catch_sigma, log_catch_sig_scale, pred_IAA, units_indices, waa, waa_pointer_indices, agg_indices, 
+      use_indices, pred_log_indices, agg_index_sigma, log_index_sig_scale, n_years_model, bias_correct_pe, decouple_recruitment);
+    nll += nll_NAA_screen;
+    REPORT(nll_NAA_screen);
+  }
   SIMULATE if(do_simulate_data(1)){
     agg_indices = simulate_agg_indices(pred_log_indices, agg_indices, agg_index_sigma, log_index_sig_scale, use_indices);
     REPORT(agg_indices);
@@ -1012,8 +1059,10 @@ Type objective_function<Type>::operator() ()
     index_Neff, age_comp_model_indices, index_paa_pars, keep_Ipaa, keep, obsvec, agesvec, do_osa);
   nll += nll_index_acomp.sum();
   REPORT(nll_index_acomp);
-  matrix<Type> index_Neff_out = get_Neff_out(index_Neff, age_comp_model_indices, index_paa_pars);
-  REPORT(index_Neff_out);
+  if(isDouble<Type>::value){ //REPORT only, not taped
+    matrix<Type> index_Neff_out = get_Neff_out(index_Neff, age_comp_model_indices, index_paa_pars);
+    REPORT(index_Neff_out);
+  }
   //see(nll);
   SIMULATE if(do_simulate_data(1)){
     obsvec = simulate_index_paa_in_obsvec(obsvec, agesvec, pred_index_paa, use_index_paa,  keep_Ipaa, index_Neff, 
@@ -1038,8 +1087,10 @@ Type objective_function<Type>::operator() ()
       //see(log_M);
   REPORT(nll);
 
-
-  if(do_SPR_BRPs){
+  //REPORT only stores values when the template is evaluated in double (obj$report(), obj$simulate()), so reference points
+  //are only put on the AD tape when they are ADREPORTed for TMB::sdreport.
+  int adreport_SPR_BRPs = do_sdrep_BRPs & (sum_do_post_samp == 0) & (mig_type.sum() == 0) & (adreport_groups(3) == 1);
+  if(do_SPR_BRPs & (isDouble<Type>::value | adreport_SPR_BRPs)){
     //trace = 1;
     vector< array<Type>> static_SPR_res =  get_SPR_res(SPR_weights, log_M, FAA, spawn_seasons,  
       spawn_regions, fleet_regions, fleet_seasons, fracyr_seasons, can_move, must_move, mig_type, trans_mu_base, 
@@ -1083,6 +1134,17 @@ Type objective_function<Type>::operator() ()
     if(trace) see(log_M_static.dim);
     array<Type> mu_static = static_SPR_res(16);
     if(trace) see(mu_static.dim);
+    //all percentSPR targets: (1 x n_targets), (n_targets x n_stocks+1), (n_targets x n_fleets+n_regions+1)
+    vector<Type> log_FXSPR_static_multi = static_SPR_res(17).matrix().row(0);
+    array<Type> log_SSB_FXSPR_static_multi = static_SPR_res(18);
+    array<Type> log_Y_FXSPR_static_multi = static_SPR_res(19);
+    //percentFXSPR of FXSPR for each target
+    vector<Type> log_pFXSPR_static_multi(percentSPR.size());
+    for(int k = 0; k < percentSPR.size(); k++) {
+      int k_pF = 0;
+      if(percentFXSPR.size() == percentSPR.size()) k_pF = k;
+      log_pFXSPR_static_multi(k) = log_FXSPR_static_multi(k) + log(0.01 * percentFXSPR(k_pF));
+    }
 
     Type log_FXSPR_static = log_FXSPR_iter_static(log_FXSPR_iter_static.size()-1);
     REPORT(log_FAA_XSPR_static);
@@ -1093,16 +1155,37 @@ Type objective_function<Type>::operator() ()
     REPORT(log_YPR_FXSPR_static);
     REPORT(log_FXSPR_static);
     REPORT(log_FXSPR_iter_static);
-    REPORT(NAAPR_FXSPR_static);
-    REPORT(NAAPR0_static);
-    REPORT(YPR_srf_FXSPR_static);
+    if(report_level > 1){
+      REPORT(NAAPR_FXSPR_static);
+      REPORT(NAAPR0_static);
+      REPORT(YPR_srf_FXSPR_static);
+      REPORT(mu_static);
+    }
     REPORT(waa_ssb_static);
     REPORT(waa_catch_static);
     REPORT(mature_static);
     REPORT(sel_static);
     REPORT(FAA_static);
     REPORT(log_M_static);
-    REPORT(mu_static);
+    REPORT(log_FXSPR_static_multi);
+    REPORT(log_SSB_FXSPR_static_multi);
+    REPORT(log_Y_FXSPR_static_multi);
+    REPORT(log_pFXSPR_static_multi);
+    if(do_eq_curves & isDouble<Type>::value){ //REPORT only
+      //equilibrium curves over eq_curves_F at the same (averaged) inputs as the static SPR-based BRPs
+      vector< array<Type>> eq_curves = get_eq_curves(eq_curves_F, sel_static, spawn_seasons, spawn_regions, fleet_regions, fleet_seasons, 
+        fracyr_seasons, can_move, mig_type, get_avg_ssbfrac(fracyr_SSB_all, avg_years_ind), log_M_static, mu_static, 
+        get_avg_L(L, avg_years_ind, 0), mature_static, waa_ssb_static, waa_catch_static, SPR_weights, 
+        vector<Type> (R_XSPR.row(n_years_model-1)), SPR_weight_type, bias_correct_brps, marg_NAA_sigma, n_regions_is_small);
+      array<Type> eq_curves_SPR = eq_curves(0);
+      array<Type> eq_curves_YPR = eq_curves(1);
+      array<Type> eq_curves_SSB = eq_curves(2);
+      array<Type> eq_curves_Y = eq_curves(3);
+      REPORT(eq_curves_SPR);
+      REPORT(eq_curves_YPR);
+      REPORT(eq_curves_SSB);
+      REPORT(eq_curves_Y);
+    }
     //trace = 0;
 
     vector< array<Type>> annual_SPR_res = get_annual_SPR_res(SPR_weights, log_M, FAA, spawn_seasons,  
@@ -1127,14 +1210,31 @@ Type objective_function<Type>::operator() ()
     REPORT(log_FXSPR_iter);
     vector<Type> log_FXSPR = log_FXSPR_iter.matrix().col(9);
     REPORT(log_FXSPR);
+    array<Type> log_FXSPR_multi = annual_SPR_res(7); //n_years x n_targets
+    REPORT(log_FXSPR_multi);
+    array<Type> log_SSB_FXSPR_multi = annual_SPR_res(8); //n_years x (n_stocks + 1) x n_targets
+    REPORT(log_SSB_FXSPR_multi);
+    array<Type> log_Y_FXSPR_multi = annual_SPR_res(9); //n_years x (n_fleets + n_regions + 1) x n_targets
+    REPORT(log_Y_FXSPR_multi);
+    array<Type> log_pFXSPR_multi = log_FXSPR_multi; //percentFXSPR of FXSPR for each target
+    for(int k = 0; k < percentSPR.size(); k++) {
+      int k_pF = 0;
+      if(percentFXSPR.size() == percentSPR.size()) k_pF = k;
+      for(int y = 0; y < log_FXSPR_multi.dim(0); y++) log_pFXSPR_multi(y,k) += log(0.01 * percentFXSPR(k_pF));
+    }
+    REPORT(log_pFXSPR_multi);
 
 
-    array<Type> annual_SPR0AA = get_annual_SPR0_at_age(log_M, spawn_seasons, fracyr_seasons, can_move, must_move,
-      mig_type, trans_mu_base, L, waa_ssb,  mature_all, fracyr_SSB_all, bias_correct_brps, 
-      marg_NAA_sigma, n_regions_is_small);
-    REPORT(annual_SPR0AA);
+    if((report_level > 1) & isDouble<Type>::value){ //REPORT only
+      int process_by_year = (M_by_year.sum() > 0) || (L_model.maxCoeff() > 1);
+      for(int s = 0; s < n_stocks; s++) for(int t = 0; t < n_seasons; t++) if(mu_by_age_year(s,t,1)) process_by_year = 1;
+      array<Type> annual_SPR0AA = get_annual_SPR0_at_age(log_M, spawn_seasons, fracyr_seasons, can_move, must_move,
+        mig_type, trans_mu_base, L, waa_ssb,  mature_all, fracyr_SSB_all, bias_correct_brps, 
+        marg_NAA_sigma, process_by_year, n_regions_is_small);
+      REPORT(annual_SPR0AA);
+    }
 
-    if((sum_do_post_samp == 0) & (mig_type.sum() == 0)) {
+    if(adreport_SPR_BRPs) {
       ADREPORT(log_FXSPR);
       ADREPORT(log_SSB_FXSPR);
       ADREPORT(log_Y_FXSPR);
@@ -1144,6 +1244,16 @@ Type objective_function<Type>::operator() ()
       ADREPORT(log_SSB_FXSPR_static);
       ADREPORT(log_SPR0_static);
       ADREPORT(log_Y_FXSPR_static);
+      if(percentSPR.size() > 1) {
+        ADREPORT(log_FXSPR_multi);
+        ADREPORT(log_SSB_FXSPR_multi);
+        ADREPORT(log_Y_FXSPR_multi);
+        ADREPORT(log_FXSPR_static_multi);
+        ADREPORT(log_SSB_FXSPR_static_multi);
+        ADREPORT(log_Y_FXSPR_static_multi);
+        ADREPORT(log_pFXSPR_multi);
+        ADREPORT(log_pFXSPR_static_multi);
+      }
     }
   }
   int is_SR = 0;
@@ -1151,12 +1261,13 @@ Type objective_function<Type>::operator() ()
   if((is_SR> 0)) {
     REPORT(log_SR_a);
     REPORT(log_SR_b);
-    if(sum_do_post_samp == 0){
+    if((sum_do_post_samp == 0) & (adreport_groups(0) == 1)){
       ADREPORT(log_SR_a);
       ADREPORT(log_SR_b);
     }  
 
-    if(do_MSY_BRPs) {
+    int adreport_MSY_BRPs = do_sdrep_BRPs & (sum_do_post_samp == 0) & (adreport_groups(3) == 1) & ((n_regions == 1) | (mig_type.sum() == 0));
+    if(do_MSY_BRPs & (isDouble<Type>::value | adreport_MSY_BRPs)) {
       // trace = 1;
       vector< matrix<Type>> static_MSY_res =  get_MSY_res(recruit_model,
         log_SR_a, log_SR_b, log_M, FAA, spawn_seasons, spawn_regions, fleet_regions,
@@ -1209,7 +1320,7 @@ Type objective_function<Type>::operator() ()
       //   fracyr_seasons, which_F_age, recruit_model, log_SR_a, log_SR_b, fracyr_SSB_all, log_M, mu, L, waa_ssb, waa_catch, mature_all, n_regions_is_small,
       //   FMSY_init, trace);
 
-      if(sum_do_post_samp == 0) if((n_regions == 1) | (mig_type.sum() == 0)) {
+      if(adreport_MSY_BRPs) {
         ADREPORT(log_FMSY);
         ADREPORT(log_SSB_MSY);
         ADREPORT(log_R_MSY);
@@ -1221,17 +1332,19 @@ Type objective_function<Type>::operator() ()
       }
     }
   }
-  matrix<Type> log_index_resid(n_years_model, n_indices), log_catch_resid(n_years_model, n_fleets);
-  log_index_resid.setZero();
-  log_catch_resid.setZero();
-  for(int y = 0; y < n_years_model; y++){
-    for(int i = 0; i < n_indices; i++){
-      if(use_indices(y,i) == 1) log_index_resid(y,i) = log(agg_indices(y,i)) - pred_log_indices(y,i);
+  if(isDouble<Type>::value){ //REPORT only, not taped
+    matrix<Type> log_index_resid(n_years_model, n_indices), log_catch_resid(n_years_model, n_fleets);
+    log_index_resid.setZero();
+    log_catch_resid.setZero();
+    for(int y = 0; y < n_years_model; y++){
+      for(int i = 0; i < n_indices; i++){
+        if(use_indices(y,i) == 1) log_index_resid(y,i) = log(agg_indices(y,i)) - pred_log_indices(y,i);
+      }
+      for(int f = 0; f < n_fleets; f++) log_catch_resid(y,f) = log(agg_catch(y,f)) - pred_log_catch(y,f);
     }
-    for(int f = 0; f < n_fleets; f++) log_catch_resid(y,f) = log(agg_catch(y,f)) - pred_log_catch(y,f);
+    REPORT(log_catch_resid);
+    REPORT(log_index_resid);
   }
-  REPORT(log_catch_resid);
-  REPORT(log_index_resid);
   
   //if(reportMode==0){
   array<Type> log_FAA = get_log_FAA(FAA);
@@ -1268,18 +1381,22 @@ Type objective_function<Type>::operator() ()
   REPORT(log_FAA_by_region);
   //}
   if(sum_do_post_samp == 0){
-    ADREPORT(log_NAA_rep);
-    ADREPORT(log_SSB);
-    ADREPORT(log_SSB_all);
+    if(adreport_groups(0) == 1){ //core SSB/F
+      ADREPORT(log_SSB);
+      ADREPORT(log_SSB_all);
+      ADREPORT(log_F_tot);
+      ADREPORT(log_Fbar);
+    }
+    if(adreport_groups(1) == 1) ADREPORT(log_NAA_rep);
     //ADREPORT(log_F);
-    ADREPORT(log_FAA);
-    ADREPORT(log_FAA_tot);
-    ADREPORT(log_FAA_by_region);
-    ADREPORT(log_F_tot);
-    ADREPORT(log_Fbar);
+    if(adreport_groups(2) == 1){ //FAA detail
+      ADREPORT(log_FAA);
+      ADREPORT(log_FAA_tot);
+      ADREPORT(log_FAA_by_region);
+    }
     //ADREPORT(log_catch_resid);
     //ADREPORT(log_index_resid);
-    if((n_regions>1) & (sum(can_move)>0)){ //only adreport the necessary parameters
+    if((n_regions>1) & (sum(can_move)>0) & (adreport_groups(4) == 1)){ //only adreport the necessary parameters
       array<int> mu_sdrep_index = get_mu_sdrep_indices(mu_model, trans_mu_base);
       REPORT(mu_sdrep_index);
       vector<Type> trans_mu_base_sdrep = get_trans_mu_base_sdrep(trans_mu_base, mu_model, mu_sdrep_index);
@@ -107,9 +107,9 @@ struct log_catch_fleets_F_multi {
 
 //multiple fleets, regions,stocks
 template <class Type>
-vector<Type> get_F_from_Catch(vector<Type> Catch, array<Type> NAA, array<Type> log_M, array<Type> mu, vector<Type> L, array<Type> sel,
-  vector<Type> fracyr_season, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, vector<int> mig_type,
-  array<Type> waacatch, int trace, Type F_init)
+vector<Type> get_F_from_Catch(const vector<Type>& Catch, array<Type>& NAA, array<Type>& log_M, array<Type>& mu, const vector<Type>& L, array<Type>& sel,
+  const vector<Type>& fracyr_season, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, const vector<int>& mig_type,
+  array<Type>& waacatch, int trace, Type F_init)
 {
   //if Catch.size() = 1, a vector of size 1 is returned (global F and catch)
   //if Catch.size() = n_fleets, a vector of size n_fleets is returned (fleet-specific F and catch)
@@ -153,20 +153,20 @@ vector<Type> get_F_from_Catch(vector<Type> Catch, array<Type> NAA, array<Type> l
 
 
 template <class Type>
-array<Type> update_FAA_proj(int y, vector<int> proj_F_opt, array<Type> FAA, array<Type> NAA, array<Type> log_M, array<Type> mu,
-  matrix<Type> L, array<Type> mature_proj, array<Type> waa_ssb_proj, array<Type> waa_catch_proj, vector<int> fleet_regions, matrix<int> fleet_seasons, 
-  vector<Type> fracyr_SSB_proj, vector<int> spawn_regions, array<int> can_move, array<int> must_move, vector<int> mig_type, 
-  vector<int> avg_years_ind, int n_years_model, vector<int> which_F_age, vector<Type> fracyr_seasons, int small_dim,
-  Type percentSPR, matrix<Type> proj_Fcatch, Type percentFXSPR, Type percentFMSY, matrix<Type> R_XSPR, vector<Type> FXSPR_init, 
-  vector<Type> FMSY_init, vector<Type> F_proj_init, matrix<Type> log_a, matrix<Type> log_b, vector<int> spawn_seasons, vector<int> recruit_model, 
-  vector<Type> SPR_weights, int SPR_weight_type, int bias_correct, 
-  array<Type> marg_NAA_sigma, int trace){
+void update_FAA_proj(int y, const vector<int>& proj_F_opt, array<Type>& FAA, array<Type>& NAA, array<Type>& log_M, array<Type>& mu,
+  const matrix<Type>& L, array<Type>& mature_proj, array<Type>& waa_ssb_proj, array<Type>& waa_catch_proj, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, 
+  const vector<Type>& fracyr_SSB_proj, const vector<int>& spawn_regions, array<int>& can_move, array<int>& must_move, const vector<int>& mig_type, 
+  const vector<int>& avg_years_ind, int n_years_model, const vector<int>& which_F_age, const vector<Type>& fracyr_seasons, int small_dim,
+  Type percentSPR, const matrix<Type>& proj_Fcatch, Type percentFXSPR, Type percentFMSY, const matrix<Type>& R_XSPR, const vector<Type>& FXSPR_init, 
+  const vector<Type>& FMSY_init, const vector<Type>& F_proj_init, const matrix<Type>& log_a, const matrix<Type>& log_b, const vector<int>& spawn_seasons, const vector<int>& recruit_model, 
+  const vector<Type>& SPR_weights, int SPR_weight_type, int bias_correct, 
+  array<Type>& marg_NAA_sigma, int trace){
     /* 
      update FAA in projection year y
                    y:  year of projection (>n_years_model)
           proj_F_opt:  for each projection year, how to specify F for projection. 1: use terminal FAA, 2: use average FAA (avg_years_ind), 
                           3: F at X%SPR, 4: user-specified full-F, 5: user-specified catch, 6: use Fmsy (inputs averaged over avg_years_ind))
-                 FAA:  FAA array from main code.
+                 FAA:  FAA array from main code. Year y is filled in place.
                  NAA:  NAA array from main code
                log_M:  array from main code.
        mu:  array from main code.
@@ -294,10 +294,7 @@ array<Type> update_FAA_proj(int y, vector<int> proj_F_opt, array<Type> FAA, arra
       }
     }
   }
-  array<Type> updated_FAA = FAA;
   if(trace) see(FAA.dim);
   if(trace) see(y);
-  for(int f = 0; f < n_fleets; f++) for(int a = 0; a < n_ages; a++) updated_FAA(f,y,a) = FAA_proj(f,a);
-  
-  return updated_FAA;
+  for(int f = 0; f < n_fleets; f++) for(int a = 0; a < n_ages; a++) FAA(f,y,a) = FAA_proj(f,a);
 }
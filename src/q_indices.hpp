@@ -69,11 +69,10 @@ matrix<Type> get_nll_q_re(matrix<Type>q_repars, matrix<Type> q_re, vector<int> u
     {
       sigma_q(i) = exp(q_repars(i,0)); // conditional sd
       rho_q(i) = geninvlogit(q_repars(i,1),Type(-1), Type(1),Type(1)); // autocorrelation. using scale =1 ,2 is legacy
-      nll_q(years_use(0),i) -= dnorm(q_re(years_use(0),i), Type(0), sigma_q(i)*exp(-0.5 * log(1 - pow(rho_q(i),Type(2)))), 1);
-      for(int y = 1; y < n_y; y++)
-      {
-        nll_q(years_use(y),i) -= dnorm(q_re(years_use(y),i), rho_q(i) * q_re(years_use(y)-1,i), sigma_q(i), 1);
-      }
+      vector<Type> re_i(n_y);
+      for(int y = 0; y < n_y; y++) re_i(y) = q_re(years_use(y),i);
+      vector<Type> nll_i = dar1_re_terms(re_i, rho_q(i), sigma_q(i)*exp(-0.5 * log(1 - pow(rho_q(i),Type(2))))); //marginal sd
+      for(int y = 0; y < n_y; y++) nll_q(years_use(y),i) = nll_i(y); //keep the annual components
     }
   }
   return(nll_q);
@@ -104,8 +103,9 @@ matrix<Type> simulate_q_re(matrix<Type>q_repars, matrix<Type> q_re, vector<int>
     {
       sigma_q(i) = exp(q_repars(i,0)); // conditional sd
       rho_q(i) = geninvlogit(q_repars(i,1),Type(-1), Type(1),Type(1)); // autocorrelation, using scale =1 ,2 is legacy
-      sim_q_re(years_use(0),i) = rnorm(Type(0), sigma_q(i)*exp(-0.5 * log(1 - pow(rho_q(i),Type(2)))));
-      for(int y = 1; y < n_y; y++) sim_q_re(years_use(y),i) = rnorm(rho_q(i) * sim_q_re(years_use(y)-1,i), sigma_q(i));
+      vector<Type> re_i(n_y);
+      re_i = rar1_re(re_i, rho_q(i), sigma_q(i)*exp(-0.5 * log(1 - pow(rho_q(i),Type(2))))); //marginal sd
+      for(int y = 0; y < n_y; y++) sim_q_re(years_use(y),i) = re_i(y);
     }
   }
   return(sim_q_re);
@@ -9,7 +9,6 @@ vector<Type> get_nll_sel(vector<int> selblock_models_re, vector<int> n_years_sel
                 selpars_re: (n_selbocks x n_years x n_ages) deviations in selectivity parameters (random effects), length = sum(n_selpars)*n_years per block
                 sel_repars: parameters controlling selpars_re, dim = n_blocks, 3 (sigma, rho, rho_y)
   */
-  using namespace density;
   int n_selblocks = selblock_models_re.size();
   vector<Type> nll_sel(n_selblocks);
   nll_sel.setZero();
@@ -18,7 +17,7 @@ vector<Type> get_nll_sel(vector<int> selblock_models_re, vector<int> n_years_sel
 
     if(selblock_models_re(b) > 1){
       // fill in sel devs from RE vector, selpars_re (fixed at 0 if RE off)
-      array<Type> tmp(n_years_selblocks(b), n_selpars_est(b));
+      matrix<Type> tmp(n_years_selblocks(b), n_selpars_est(b));
       for(int i = 0; i < n_years_selblocks(b); i++) for(int j=0; j<n_selpars_est(b); j++){
         tmp(i,j) = selpars_re(b,i,j);
         //tmp.col(j) = selpars_re.segment(istart,n_years_selblocks(b));
@@ -35,18 +34,18 @@ vector<Type> get_nll_sel(vector<int> selblock_models_re, vector<int> n_years_sel
       if((selblock_models_re(b) == 2) | (selblock_models_re(b) == 5)){
         // 2D AR1 process on selectivity parameter deviations
         Type Sigma_sig_sel = pow(pow(sigma,2) / ((1-pow(rho_y,2))*(1-pow(rho,2))),0.5);
-        nll_sel(b) += SCALE(SEPARABLE(AR1(rho),AR1(rho_y)), Sigma_sig_sel)(tmp);
+        nll_sel(b) += d2dar1_re(tmp, rho_y, rho, Sigma_sig_sel);
       } else {
         // 1D AR1 process on selectivity parameter deviations
         if(selblock_models_re(b) == 3){ // ar1 across parameters in selblock, useful for age-specific pars.
-          vector<Type> tmp0 = tmp.matrix().row(0); //random effects are constant across years 
+          vector<Type> tmp0 = tmp.row(0); //random effects are constant across years 
           Type Sigma_sig_sel = pow(pow(sigma,2) / (1-pow(rho,2)),0.5);
-          nll_sel(b) += SCALE(AR1(rho), Sigma_sig_sel)(tmp0);
+          nll_sel(b) += dar1_re(tmp0, rho, Sigma_sig_sel);
         } else { // selblock_models_re(b) = 4, ar1_y, not sure if this one really makes sense.
-          vector<Type> tmp0 = tmp.matrix().col(0); //random effects are constant within years 
+          vector<Type> tmp0 = tmp.col(0); //random effects are constant within years 
           Type Sigma_sig_sel = pow(pow(sigma,2) / (1-pow(rho_y,2)),0.5);
           //Sigma_sig_sel = sigma;
-          nll_sel(b) += SCALE(AR1(rho_y), Sigma_sig_sel)(tmp0);
+          nll_sel(b) += dar1_re(tmp0, rho_y, Sigma_sig_sel);
         }
       }
     }
@@ -65,7 +64,6 @@ array<Type> simulate_selpars_re(vector<int> selblock_models_re, vector<int> n_ye
                 selpars_re: (n_selbocks x n_years x n_ages) deviations in selectivity parameters (random effects), length = sum(n_selpars)*n_years per block
                 sel_repars: parameters controlling selpars_re, dim = n_blocks, 3 (sigma, rho, rho_y)
   */
-  using namespace density;
   int n_selblocks = selblock_models_re.size();
   //int istart = 0;
   array<Type> sim_selpars_re = selpars_re;
@@ -73,7 +71,7 @@ array<Type> simulate_selpars_re(vector<int> selblock_models_re, vector<int> n_ye
 
     if(selblock_models_re(b) > 1){
       // fill in sel devs from RE vector, selpars_re (fixed at 0 if RE off)
-      array<Type> tmp(n_years_selblocks(b), n_selpars_est(b));
+      matrix<Type> tmp(n_years_selblocks(b), n_selpars_est(b));
       for(int i = 0; i < n_years_selblocks(b); i++) for(int j=0; j<n_selpars_est(b); j++){
         tmp(i,j) = selpars_re(b,i,j);
         //tmp.col(j) = selpars_re.segment(istart,n_years_selblocks(b));
@@ -91,22 +89,21 @@ array<Type> simulate_selpars_re(vector<int> selblock_models_re, vector<int> n_ye
       if((selblock_models_re(b) == 2) | (selblock_models_re(b) == 5)){
         // 2D AR1 process on selectivity parameter deviations
         Sigma_sig_sel = pow(pow(sigma,2) / ((1-pow(rho_y,2))*(1-pow(rho,2))),0.5);
-        SEPARABLE(AR1(rho),AR1(rho_y)).simulate(tmp);
+        tmp = r2dar1_re(tmp, rho_y, rho, Sigma_sig_sel);
       } else {
         // 1D AR1 process on selectivity parameter deviations
         if(selblock_models_re(b) == 3){ // ar1 across parameters in selblock, useful for age-specific pars.
-          vector<Type> tmp0 = tmp.matrix().row(0); //random effects are constant across years 
+          vector<Type> tmp0 = tmp.row(0); //random effects are constant across years 
           Sigma_sig_sel = pow(pow(sigma,2) / (1-pow(rho,2)),0.5);
-          AR1(rho).simulate(tmp0);
+          tmp0 = rar1_re(tmp0, rho, Sigma_sig_sel);
           for(int y = 0; y < tmp.rows(); y++) for(int i = 0; i < tmp0.size(); i++) tmp(y,i) = tmp0(i);
         } else { // selblock_models_re(b) = 4, ar1_y, not sure if this one really makes sense.
-          vector<Type> tmp0 = tmp.matrix().col(0); //random effects are constant within years 
+          vector<Type> tmp0 = tmp.col(0); //random effects are constant within years 
           Sigma_sig_sel = pow(pow(sigma,2) / (1-pow(rho_y,2)),0.5);
-          AR1(rho_y).simulate(tmp0);
-          for(int a = 0; a < tmp.cols(); a++) tmp.col(a) = tmp0;
+          tmp0 = rar1_re(tmp0, rho_y, Sigma_sig_sel);
+          for(int a = 0; a < tmp.cols(); a++) for(int y = 0; y < tmp.rows(); y++) tmp(y,a) = tmp0(y);
         }
       }
-      tmp = tmp * Sigma_sig_sel;
       //istart -= n_selpars_est(b) * n_years_selblocks(b); //bring it back to the beginning for this selblock
       for(int j=0; j<n_selpars_est(b); j++){
         for(int y = 0; y < n_years_selblocks(b); y++){
@@ -168,9 +165,31 @@ vector<matrix<Type> > get_selpars_re_mats(vector<int> n_selpars, matrix<int> sel
   return selpars_re_mats; //even if not simulated
 }
 
+inline vector<int> get_sel_year_src(int b, matrix<int> selblock_years, vector<int> selblock_models_re){
+  /* 
+    which year's selectivity (parameters) to use for each year of block b. Only active years (selblock_years = 1) of blocks with 
+    random effects differ from the mean, so those are calculated and all other years use the first year without random effects.
+                 b: selectivity block
+    selblock_years: n_years_model x n_selblocks, = 1 if block covers year, = 0 if not
+    selblock_models_re: (n_selblocks) 1 = no RE, 2 = IID, 3 = ar1, 4 = ar1_y, 5 = 2dar1
+  */
+  int n_years = selblock_years.rows();
+  vector<int> year_src(n_years);
+  int ref = -1;
+  for(int y = 0; y < n_years; y++) {
+    if((selblock_models_re(b) > 1) && (selblock_years(y,b) == 1)) year_src(y) = y;
+    else {
+      if(ref < 0) ref = y;
+      year_src(y) = ref;
+    }
+  }
+  return year_src;
+}
+
 template <class Type>
 vector<matrix<Type> > get_selpars(vector<int> selblock_models, vector<int> n_selpars, matrix<Type> logit_selpars, 
-  vector<matrix<Type> >  selpars_re_mats, matrix<Type> selpars_lower, matrix<Type> selpars_upper, int n_years_model){
+  vector<matrix<Type> >  selpars_re_mats, matrix<Type> selpars_lower, matrix<Type> selpars_upper, int n_years_model,
+  matrix<int> selblock_years, vector<int> selblock_models_re){
   /* 
     get vector of matrices of selectivity parameters.
       selblock_models: n_selblocks. which (mean) selectivity model for each block
@@ -180,6 +199,8 @@ vector<matrix<Type> > get_selpars(vector<int> selblock_models, vector<int> n_sel
         selpars_lower: n_selblocks x (6+n_ages) lower bound of selectivity parameters for invlogit transformation (default = 0)
         selpars_upper: n_selblocks x (6+n_ages) upper bound of selectivity parameters for invlogit transformation (default = 1 or n_ages)
         n_years_model: number of non-projection years in the model
+       selblock_years: n_years_model x n_selblocks, = 1 if block covers year, = 0 if not
+    selblock_models_re: (n_selblocks) 1 = no RE, 2 = IID, 3 = ar1, 4 = ar1_y, 5 = 2dar1
   */
 
   int n_selblocks = selblock_models.size();
@@ -192,8 +213,13 @@ vector<matrix<Type> > get_selpars(vector<int> selblock_models, vector<int> n_sel
 
     // get selpars = mean + deviations
     matrix<Type> tmp1(n_years_model, n_selpars(b));
+    vector<int> year_src = get_sel_year_src(b, selblock_years, selblock_models_re);
     for(int j=jstart; j<(jstart+n_selpars(b)); j++){ // transform from logit-scale
       for(int i=0; i<n_years_model; i++){
+        if(year_src(i) != i) {
+          tmp1(i,j-jstart) = tmp1(year_src(i),j-jstart);
+          continue;
+        }
         Type logit_sel_re = logit_selpars(b,j) + selpars_re_mats(b)(i,j-jstart);
         tmp1(i,j-jstart) = geninvlogit(logit_sel_re,selpars_lower(b,j), selpars_upper(b,j),Type(1));
         //tmp1(i,j-jstart) = selpars_lower(b,j) + (selpars_upper(b,j) - selpars_lower(b,j)) / (1.0 + exp(-(logit_selpars(b,j) + selpars_re_mats(b).matrix()(i,j-jstart))));
@@ -207,7 +233,7 @@ vector<matrix<Type> > get_selpars(vector<int> selblock_models, vector<int> n_sel
 
 template <class Type>
 vector<matrix<Type> > get_selAA(int n_years, int n_ages, int n_selblocks, vector<matrix<Type> > selpars, 
-  vector<int> selblock_models) {
+  vector<int> selblock_models, matrix<int> selblock_years, vector<int> selblock_models_re) {
   /* 
     get vector of matrices of selectivity at age.
               n_years: n_years_model 
@@ -215,17 +241,20 @@ vector<matrix<Type> > get_selAA(int n_years, int n_ages, int n_selblocks, vector
           n_selblocks: n_selblocks
               selpars: vector of matrices of selectivity parameters
       selblock_models: n_selblocks. which (mean) selectivity model for each block
+       selblock_years: n_years_model x n_selblocks, = 1 if block covers year, = 0 if not
+    selblock_models_re: (n_selblocks) 1 = no RE, 2 = IID, 3 = ar1, 4 = ar1_y, 5 = 2dar1
   */
   vector<matrix<Type> > selAA(n_selblocks);
   for(int b = 0; b < n_selblocks; b++)
   {
     matrix<Type> tmp(n_years, n_ages);
+    vector<int> year_src = get_sel_year_src(b, selblock_years, selblock_models_re);
     if(selblock_models(b) == 1) tmp = selpars(b); //proportions at age
     else
     { //logistic or double-logistic
       if(selblock_models(b) == 2)
       { //increasing logistic
-        for(int y = 0; y < n_years; y++)
+        for(int y = 0; y < n_years; y++) if(year_src(y) == y)
         {
           Type a50 = selpars(b)(y,0); // a50 parameter in year y
           Type k = selpars(b)(y,1); //  1/slope in year y
@@ -242,7 +271,7 @@ vector<matrix<Type> > get_selAA(int n_years, int n_ages, int n_selblocks, vector
       { //double logistic
         if(selblock_models(b) == 3)
         {
-          for(int y = 0; y < n_years; y++)
+          for(int y = 0; y < n_years; y++) if(year_src(y) == y)
           {
             Type a50_1 = selpars(b)(y,0); // a50 parameter in year y
             Type k_1 = selpars(b)(y,1); //  1/slope in year y
@@ -259,7 +288,7 @@ vector<matrix<Type> > get_selAA(int n_years, int n_ages, int n_selblocks, vector
         }
         else //model 4: declining logistic
         {
-          for(int y = 0; y < n_years; y++)
+          for(int y = 0; y < n_years; y++) if(year_src(y) == y)
           {
             Type a50 = selpars(b)(y,0); // a50 parameter in year y
             Type k = selpars(b)(y,1); //  1/slope in year y
@@ -274,6 +303,8 @@ vector<matrix<Type> > get_selAA(int n_years, int n_ages, int n_selblocks, vector
         }
       }
     }
+    //years that share selectivity with an earlier year
+    if(selblock_models(b) > 1) for(int y = 0; y < n_years; y++) if(year_src(y) != y) tmp.row(y) = tmp.row(year_src(y));
     selAA(b) = tmp;
   }
   return selAA;
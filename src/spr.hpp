@@ -1,8 +1,8 @@
 
 template <class T>
-array<T> get_SPR(vector<int> spawn_seasons, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, 
-  vector<int> mig_type, vector<T> fracyr_SSB, array<T> FAA, array<T> log_M, array<T> mu, vector<T> L, 
-  array<T> mature, array<T> waa_ssb, vector<T> fracyr_seasons, int age_specific, int small_dim, int trace = 0, int numbers = 0){
+array<T> get_SPR(const vector<int>& spawn_seasons, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, 
+  const vector<int>& mig_type, const vector<T>& fracyr_SSB, array<T>& FAA, array<T>& log_M, array<T>& mu, const vector<T>& L, 
+  array<T>& mature, array<T>& waa_ssb, const vector<T>& fracyr_seasons, int age_specific, int small_dim, int trace = 0, int numbers = 0){
   /* 
     calculate equilibrium spawning biomass per recruit (at age) by stock and region. If movement is set up approriately 
     all fish can be made to return to a single spawning region for each stock.
@@ -127,10 +127,10 @@ array<T> get_SPR(vector<int> spawn_seasons, vector<int> fleet_regions, matrix<in
 }
 
 template <class T>
-array<T> get_SPR(vector<int> spawn_seasons, vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, 
-  vector<int> mig_type, vector<T> fracyr_SSB, array<T> FAA, array<T> log_M, array<T> mu, vector<T> L, 
-  array<T> mature, array<T> waa_ssb, vector<T> fracyr_seasons, int age_specific, int bias_correct, 
-  array<T> marg_NAA_sigma, int small_dim, int trace = 0, int numbers = 0){
+array<T> get_SPR(const vector<int>& spawn_seasons, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, 
+  const vector<int>& mig_type, const vector<T>& fracyr_SSB, array<T>& FAA, array<T>& log_M, array<T>& mu, const vector<T>& L, 
+  array<T>& mature, array<T>& waa_ssb, const vector<T>& fracyr_seasons, int age_specific, int bias_correct, 
+  array<T>& marg_NAA_sigma, int small_dim, int trace = 0, int numbers = 0){
   /* 
     calculate equilibrium spawning biomass per recruit (at age) by stock and region. If movement is set up approriately 
     all fish can be made to return to a single spawning region for each stock.
@@ -250,9 +250,9 @@ array<T> get_SPR(vector<int> spawn_seasons, vector<int> fleet_regions, matrix<in
 }
 
 template <class T>
-array<T> get_YPR_srf(vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, 
-  vector<int> mig_type, array<T> FAA, array<T> log_M, array<T> mu, vector<T> L, array<T> waacatch, 
-  vector<T> fracyr_seasons, int age_specific, int small_dim){
+array<T> get_YPR_srf(const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, 
+  const vector<int>& mig_type, array<T>& FAA, array<T>& log_M, array<T>& mu, const vector<T>& L, array<T>& waacatch, 
+  const vector<T>& fracyr_seasons, int age_specific, int small_dim){
   /* 
     calculate equilibrium yield per recruit (at age) by stock and region.
         fleet_regions: vector of indicators telling which region each fleet is operating
@@ -331,10 +331,10 @@ array<T> get_YPR_srf(vector<int> fleet_regions, matrix<int> fleet_seasons, array
 }
 
 template <class T>
-array<T> get_YPR_srf(vector<int> fleet_regions, matrix<int> fleet_seasons, array<int> can_move, 
-  vector<int> mig_type, array<T> FAA, array<T> log_M, array<T> mu, vector<T> L, array<T> waacatch, 
-  vector<T> fracyr_seasons, int age_specific, int bias_correct, 
-  array<T> marg_NAA_sigma, int small_dim){
+array<T> get_YPR_srf(const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, array<int>& can_move, 
+  const vector<int>& mig_type, array<T>& FAA, array<T>& log_M, array<T>& mu, const vector<T>& L, array<T>& waacatch, 
+  const vector<T>& fracyr_seasons, int age_specific, int bias_correct, 
+  array<T>& marg_NAA_sigma, int small_dim){
   /* 
     calculate equilibrium yield per recruit (at age) by stock and region.
         fleet_regions: vector of indicators telling which region each fleet is operating
@@ -409,9 +409,9 @@ array<T> get_YPR_srf(vector<int> fleet_regions, matrix<int> fleet_seasons, array
 }
 
 template <class Type>
-matrix<Type> get_RXSPR(array<Type> all_NAA, vector<int> spawn_regions, int n_years_model, int n_years_proj, 
-  int XSPR_R_opt, vector<int> XSPR_R_avg_yrs, 
-  array<Type> marg_NAA_sigma){
+matrix<Type> get_RXSPR(array<Type>& all_NAA, const vector<int>& spawn_regions, int n_years_model, int n_years_proj, 
+  int XSPR_R_opt, const vector<int>& XSPR_R_avg_yrs, 
+  array<Type>& marg_NAA_sigma){
   // array<Type> log_NAA_sigma){
   //R_XSPR is needed for projections and reference points
   array<Type> NAA = extract_NAA(all_NAA);
@@ -619,15 +619,140 @@ struct spr_F_spatial {
   }
 };
 
+/* calculate aggregate SSB/R at a set of F values (one for each X%SPR target) for spatial model across stocks and regions */
+template<class Type>
+struct spr_F_spatial_batch {
+  // Data and parameter objects for calculation:
+  vector<int> spawn_seasons;
+  vector<int> spawn_regions;
+  vector<int> fleet_regions;
+  matrix<int> fleet_seasons;
+  array<int> can_move;
+  vector<int> mig_type;
+  vector<Type> fracyr_SSB;
+  array<Type> selectivity;
+  array<Type> log_M;
+  array<Type> mu;
+  vector<Type> L;
+  array<Type> mature;
+  array<Type> waa_ssb;
+  vector<Type> fracyr_seasons;
+  vector<Type> SPR_weights; //how to weight stock-specific SSB/R for aggregate SSB/R.
+  int bias_correct;
+  array<Type> marg_NAA_sigma;
+  int small_dim;
+
+  // Constructor
+  spr_F_spatial_batch(
+  vector<int> spawn_seasons_,
+  vector<int> spawn_regions_,
+  vector<int> fleet_regions_,
+  matrix<int> fleet_seasons_,
+  array<int> can_move_,
+  vector<int> mig_type_,
+  vector<Type> fracyr_SSB_,
+  array<Type> selectivity_,
+  array<Type> log_M_,
+  array<Type> mu_,
+  vector<Type> L_,
+  array<Type> mature_,
+  array<Type> waa_ssb_,
+  vector<Type> fracyr_seasons_,
+  vector<Type> SPR_weights_,
+  int bias_correct_,
+  array<Type> marg_NAA_sigma_,
+  int small_dim_) :
+    spawn_seasons(spawn_seasons_),
+    spawn_regions(spawn_regions_),
+    fleet_regions(fleet_regions_),
+    fleet_seasons(fleet_seasons_),
+    can_move(can_move_),
+    mig_type(mig_type_),
+    fracyr_SSB(fracyr_SSB_),
+    selectivity(selectivity_),
+    log_M(log_M_),
+    mu(mu_),
+    L(L_),
+    mature(mature_),
+    waa_ssb(waa_ssb_),
+    fracyr_seasons(fracyr_seasons_),
+    SPR_weights(SPR_weights_),
+    bias_correct(bias_correct_),
+    marg_NAA_sigma(marg_NAA_sigma_),
+    small_dim(small_dim_) {}
+
+  //weighted SSB/R for each element of log_F. Inputs are cast to T once and shared by all targets.
+  template <typename T>
+  vector<T> each(vector<T> log_F) {
+    int n_stocks = log_M.dim(0);
+    int n_regions = log_M.dim(1);
+    int n_ages = log_M.dim(2);
+    int n_fleets = selectivity.rows();
+    vector<T> fracyrssbT = fracyr_SSB.template cast<T>();
+    array<T> logMbaseT(n_stocks,n_regions,n_ages), marg_NAA_sigmaT(n_stocks, n_regions, n_ages);
+    for(int s = 0; s < n_stocks; s++) for(int r = 0; r < n_regions; r++) for(int a = 0; a < n_ages; a++){
+      logMbaseT(s,r,a) = T(log_M(s,r,a));
+      marg_NAA_sigmaT(s,r,a) = T(marg_NAA_sigma(s,r,a));
+    }
+    array<T> muT(mu.dim(0),mu.dim(1),mu.dim(2),mu.dim(3),mu.dim(4));
+    if(n_regions>1) for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++) for(int t = 0; t < mu.dim(2); t++) {
+      for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++) {
+        muT(s,a,t,r,rr) = T(mu(s,a,t,r,rr));
+      }
+    }
+    vector<T> LT = L.template cast<T>();
+    array<T> matT(mature.dim(0),mature.dim(1));
+    for(int i = 0; i < mature.dim(0); i++) for(int j = 0; j < mature.dim(1); j++) matT(i,j) = T(mature(i,j));
+    array<T> waassbT(waa_ssb.dim(0), waa_ssb.dim(1));
+    for(int i = 0; i < waa_ssb.dim(0); i++) for(int j = 0; j < waa_ssb.dim(1); j++) waassbT(i,j) = T(waa_ssb(i,j));
+    vector<T> fracyrseasonT = fracyr_seasons.template cast<T>();
+
+    vector<T> SPR(log_F.size());
+    SPR.setZero();
+    array<T> FAA(n_fleets,n_ages);
+    for(int k = 0; k < log_F.size(); k++){
+      for(int f = 0; f < n_fleets; f++) for(int a = 0; a < n_ages; a++) FAA(f,a) = T(selectivity(f,a)) * exp(log_F(k));
+      array<T> SPR_sr = get_SPR(spawn_seasons, fleet_regions, fleet_seasons, can_move, mig_type, fracyrssbT, FAA, logMbaseT,
+        muT, LT, matT, waassbT, fracyrseasonT, 0, bias_correct, marg_NAA_sigmaT, small_dim, 0, 0);
+      for(int s = 0; s < n_stocks; s++) SPR(k) += T(SPR_weights(s)) * SPR_sr(s,spawn_regions(s)-1,spawn_regions(s)-1);
+    }
+    return SPR;
+  }
+
+  //sum across targets. Each target depends only on its own log_F, so the gradient of the sum is the diagonal of the
+  //jacobian and all Newton steps come from a single reverse sweep.
+  template <typename T>
+  T operator()(vector<T> log_F) {
+    return each(log_F).sum();
+  }
+};
+
+//Newton iterations for log(F) at each of several X%SPR targets. returns n_iter x n_targets
+template <class Type>
+matrix<Type> get_log_FXSPR_iter_batch(spr_F_spatial_batch<Type> sprF, const vector<Type>& percentSPR, Type SPR0, Type F_init, int n_iter){
+  int n_targets = percentSPR.size();
+  matrix<Type> log_FXSPR_iter(n_iter, n_targets);
+  log_FXSPR_iter.row(0).fill(log(F_init));
+  for(int i=0; i<n_iter-1; i++) {
+    vector<Type> log_FXSPR_i = log_FXSPR_iter.row(i);
+    vector<Type> grad_spr_F = autodiff::gradient(sprF,log_FXSPR_i);
+    vector<Type> SPR_i = sprF.each(log_FXSPR_i);
+    for(int k = 0; k < n_targets; k++) {
+      log_FXSPR_iter(i+1,k) = log_FXSPR_iter(i,k) - (SPR_i(k) - 0.01*percentSPR(k) * SPR0)/grad_spr_F(k);
+    }
+  }
+  return log_FXSPR_iter;
+}
+
 //takes a single year of values for inputs (reduce dimensions appropriately)
 //returns just the "solved" log_FXSPR value
 template <class Type>
-vector<Type> get_FXSPR(vector<int> spawn_seasons, vector<int> spawn_regions, vector<int> fleet_regions, matrix<int> fleet_seasons,
-  array<int> can_move, vector<int> mig_type, vector<Type> ssbfrac, array<Type> sel, array<Type> log_M, array<Type> mu, 
-  vector<Type> L, array<Type> mat,  array<Type> waassb, vector<Type> fracyr_seasons, vector<Type> R_XSPR, 
+vector<Type> get_FXSPR(const vector<int>& spawn_seasons, const vector<int>& spawn_regions, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons,
+  array<int>& can_move, const vector<int>& mig_type, const vector<Type>& ssbfrac, array<Type>& sel, array<Type>& log_M, array<Type>& mu, 
+  const vector<Type>& L, array<Type>& mat,  array<Type>& waassb, const vector<Type>& fracyr_seasons, const vector<Type>& R_XSPR, 
   Type percentSPR, vector<Type> SPR_weights, int SPR_weight_type, int bias_correct, 
-  array<Type> marg_NAA_sigma, 
-  // array<Type> log_NAA_sigma, 
+  array<Type>& marg_NAA_sigma, 
+  // array<Type>& log_NAA_sigma, 
   int small_dim, Type F_init, int n_iter, int trace, int by_region = 0) {
   int n_stocks = spawn_seasons.size();
   int n_fleets = fleet_regions.size();
@@ -716,11 +841,11 @@ vector<Type> get_FXSPR(vector<int> spawn_seasons, vector<int> spawn_regions, vec
 //takes a single year of values for inputs including log_SPR0 (reduce dimensions appropriately)
 //returns just the "solved" log_FXSPR value
 template <class Type>
-vector<Type> get_FXSPR(vector<int> spawn_seasons, vector<int> spawn_regions, vector<int> fleet_regions, matrix<int> fleet_seasons,
-  array<int> can_move, vector<int> mig_type, vector<Type> ssbfrac, array<Type> sel, array<Type> log_M, array<Type> mu, 
-  vector<Type> L, array<Type> mat,  array<Type> waassb, vector<Type> fracyr_seasons, vector<Type> R_XSPR, vector<Type> log_SPR0,
+vector<Type> get_FXSPR(const vector<int>& spawn_seasons, const vector<int>& spawn_regions, const vector<int>& fleet_regions, const matrix<int>& fleet_seasons,
+  array<int>& can_move, const vector<int>& mig_type, const vector<Type>& ssbfrac, array<Type>& sel, array<Type>& log_M, array<Type>& mu, 
+  const vector<Type>& L, array<Type>& mat,  array<Type>& waassb, const vector<Type>& fracyr_seasons, const vector<Type>& R_XSPR, const vector<Type>& log_SPR0,
   Type percentSPR, vector<Type> SPR_weights, int SPR_weight_type, int bias_correct, 
-  array<Type> marg_NAA_sigma, 
+  array<Type>& marg_NAA_sigma, 
   int small_dim, Type F_init, int n_iter, int trace, int by_region = 0) {
   int n_stocks = spawn_seasons.size();
   int n_fleets = fleet_regions.size();
@@ -773,22 +898,22 @@ vector<Type> get_FXSPR(vector<int> spawn_seasons, vector<int> spawn_regions, vec
 
 
 template <class Type>
-vector< array <Type> > get_SPR_res(vector<Type> SPR_weights, array<Type> log_M, array<Type> FAA, vector<int> spawn_seasons,  
-  vector<int> spawn_regions,
-  vector<int> fleet_regions, 
-  matrix<int> fleet_seasons,
-  vector<Type> fracyr_seasons,
-  array<int> can_move,
-  array<int> must_move,
-  vector<int> mig_type,
-  array<Type> trans_mu_base, 
-  matrix<Type> L,
-  int which_F_age, array<Type> waa_ssb, array<Type> waa_catch, 
-  array<Type> mature, Type percentSPR, array<Type> NAA, matrix<Type> fracyr_SSB, Type F_init, 
-  vector<int> years_M, vector<int> years_mu, vector<int> years_L, vector<int> years_mat, vector<int> years_sel, 
-  vector<int> years_waa_ssb, vector<int> years_waa_catch, vector<Type> R_XSPR,
+vector< array <Type> > get_SPR_res(vector<Type> SPR_weights, array<Type>& log_M, array<Type>& FAA, const vector<int>& spawn_seasons,  
+  const vector<int>& spawn_regions,
+  const vector<int>& fleet_regions, 
+  const matrix<int>& fleet_seasons,
+  const vector<Type>& fracyr_seasons,
+  array<int>& can_move,
+  array<int>& must_move,
+  const vector<int>& mig_type,
+  array<Type>& trans_mu_base, 
+  const matrix<Type>& L,
+  int which_F_age, array<Type>& waa_ssb, array<Type>& waa_catch, 
+  array<Type>& mature, const vector<Type>& percentSPR, array<Type>& NAA, const matrix<Type>& fracyr_SSB, Type F_init, 
+  const vector<int>& years_M, const vector<int>& years_mu, const vector<int>& years_L, const vector<int>& years_mat, const vector<int>& years_sel, 
+  const vector<int>& years_waa_ssb, const vector<int>& years_waa_catch, const vector<Type>& R_XSPR,
   int small_dim, int SPR_weight_type, int bias_correct, 
-  array<Type> marg_NAA_sigma, 
+  array<Type>& marg_NAA_sigma, 
   int trace = 0, int n_iter = 10) {
   //gets SPR-based BRP information for a year, or inputs may be averaged over specified years.  
   if(trace) see("inside get_SPR_res");
@@ -859,26 +984,16 @@ vector< array <Type> > get_SPR_res(vector<Type> SPR_weights, array<Type> log_M,
   for(int s = 0; s < n_stocks; s++) SPR0 += SPR_weights(s) * SPR0_all(s,spawn_regions(s)-1,spawn_regions(s)-1); 
   if(trace) see(SPR0);
 
-  vector<Type> log_FXSPR_i(1), log_FXSPR_iter(n_iter);
-  log_FXSPR_iter(0) = log(F_init);
-
-  if(trace) see(log_FXSPR_iter(0));
-  // trace = 0;
-  spr_F_spatial<Type> sprF(spawn_seasons, spawn_regions, fleet_regions, fleet_seasons, can_move, mig_type, ssbfrac, sel, log_M_avg,
-    mu_avg, L_avg, mat, waa_ssb_avg, fracyr_seasons, SPR_weights, 0, bias_correct, 
+  //all X%SPR targets are solved together. The first target (percentSPR(0)) defines the primary reference points.
+  int n_targets = percentSPR.size();
+  spr_F_spatial_batch<Type> sprF(spawn_seasons, spawn_regions, fleet_regions, fleet_seasons, can_move, mig_type, ssbfrac, sel, log_M_avg,
+    mu_avg, L_avg, mat, waa_ssb_avg, fracyr_seasons, SPR_weights, bias_correct, 
     marg_NAA_sigma, 
-    // log_NAA_sigma, 
-    small_dim, trace);
-  if(trace) see("after spr_F_spatial sprF defined");
-  // trace = 1;
-  for(int i=0; i<n_iter-1; i++) {
-    if(trace) see(i);
-    log_FXSPR_i(0) = log_FXSPR_iter(i);
-    matrix<Type> grad_spr_F = autodiff::jacobian(sprF,log_FXSPR_i);
-    //vector<Type> grad_spr_F = autodiff::gradient(sprF,log_FXSPR_i);
-    Type SPR_i = sprF(log_FXSPR_i)(0);
-    log_FXSPR_iter(i+1) = log_FXSPR_iter(i) - (SPR_i - 0.01*percentSPR * SPR0)/grad_spr_F(0,0);
-  }
+    small_dim);
+  if(trace) see("after spr_F_spatial_batch sprF defined");
+  matrix<Type> log_FXSPR_iter_all = get_log_FXSPR_iter_batch(sprF, percentSPR, SPR0, F_init, n_iter);
+  if(trace) see(log_FXSPR_iter_all);
+  vector<Type> log_FXSPR_iter = log_FXSPR_iter_all.col(0);
   array<Type> FAA_XSPR(n_fleets, n_ages);
   array<Type> log_FAA_XSPR(n_fleets+n_regions+1, n_ages);
   log_FAA_XSPR.setZero();
@@ -944,7 +1059,34 @@ vector< array <Type> > get_SPR_res(vector<Type> SPR_weights, array<Type> log_M,
   log_SSB_XSPR(0,n_stocks) = log(log_SSB_XSPR(0,n_stocks));
   //see(log_SPR);
   //see(log_SPR0);
-  vector< array<Type> > res(17); 
+
+  //FXSPR, SSB and yield at each X%SPR target. first row is the same as the primary values above.
+  array<Type> log_FXSPR_multi(1,n_targets), log_SSB_XSPR_multi(n_targets,n_stocks+1), log_Y_XSPR_multi(n_targets,n_fleets+n_regions+1);
+  log_SSB_XSPR_multi.setZero(); log_Y_XSPR_multi.setZero();
+  for(int k = 0; k < n_targets; k++) log_FXSPR_multi(0,k) = log_FXSPR_iter_all(n_iter-1,k);
+  for(int s = 0; s <= n_stocks; s++) log_SSB_XSPR_multi(0,s) = log_SSB_XSPR(0,s);
+  for(int f = 0; f <= n_fleets+n_regions; f++) log_Y_XSPR_multi(0,f) = log_Y_XSPR(0,f);
+  for(int k = 1; k < n_targets; k++) {
+    array<Type> FAA_k(n_fleets, n_ages);
+    for(int f = 0; f < n_fleets; f++) for(int a = 0; a < n_ages; a++) FAA_k(f,a) = sel(f,a) * exp(log_FXSPR_multi(0,k));
+    array<Type> SPR_k = get_SPR(spawn_seasons, fleet_regions, fleet_seasons, can_move, mig_type, ssbfrac, FAA_k, log_M_avg, mu_avg, L_avg, 
+      mat, waa_ssb_avg, fracyr_seasons, 0, bias_correct, marg_NAA_sigma, small_dim, 0, 0);
+    array<Type> YPR_srf_k = get_YPR_srf(fleet_regions, fleet_seasons, can_move, mig_type, FAA_k, log_M_avg, mu_avg, L_avg, waa_catch_avg, 
+      fracyr_seasons, 0, bias_correct, marg_NAA_sigma, small_dim);
+    for(int s = 0; s < n_stocks; s++) {
+      log_SSB_XSPR_multi(k,s) = log(R_XSPR(s) * SPR_k(s,spawn_regions(s)-1,spawn_regions(s)-1));
+      log_SSB_XSPR_multi(k,n_stocks) += R_XSPR(s) * SPR_k(s,spawn_regions(s)-1,spawn_regions(s)-1);
+      for(int f = 0; f < n_fleets; f++) {
+        log_Y_XSPR_multi(k,f) += R_XSPR(s) * YPR_srf_k(s,spawn_regions(s)-1,f); //not logged yet
+        log_Y_XSPR_multi(k,n_fleets+fleet_regions(f)-1) += R_XSPR(s) * YPR_srf_k(s,spawn_regions(s)-1,f);
+        log_Y_XSPR_multi(k,n_fleets+n_regions) += R_XSPR(s) * YPR_srf_k(s,spawn_regions(s)-1,f);
+      }
+    }
+    log_SSB_XSPR_multi(k,n_stocks) = log(log_SSB_XSPR_multi(k,n_stocks));
+    for(int f = 0; f <= n_fleets+n_regions; f++) log_Y_XSPR_multi(k,f) = log(log_Y_XSPR_multi(k,f));
+  }
+
+  vector< array<Type> > res(20); 
   res(0) = log_FAA_XSPR; // log_FAA at FXSPR by fleet and across fleets
   res(1) = log_SSB_XSPR; //log_SSB_FXSPR
   res(2) = log_Y_XSPR; //log_Y_FXSPR
@@ -976,34 +1118,157 @@ vector< array <Type> > get_SPR_res(vector<Type> SPR_weights, array<Type> log_M,
   res(15) = log_M_avg;
   if(trace) see(mu_avg.dim);
   res(16) = mu_avg;
+  res(17) = log_FXSPR_multi;
+  res(18) = log_SSB_XSPR_multi;
+  res(19) = log_Y_XSPR_multi;
   if(trace) see("end get_SPR_res")
   return res;
 }
 
 template <class Type>
-vector< array <Type> > get_annual_SPR_res(vector<Type> SPR_weights, array<Type> log_M, array<Type> FAA, vector<int> spawn_seasons,  
-  vector<int> spawn_regions,
-  vector<int> fleet_regions, 
-  matrix<int> fleet_seasons,
-  vector<Type> fracyr_seasons,
-  array<int> can_move,
-  array<int> must_move,
-  vector<int> mig_type,
-  array<Type> trans_mu_base, 
-  matrix<Type> L,
-  vector<int> which_F_age, array<Type> waa_ssb, array<Type> waa_catch,
-  array<Type> mature, Type percentSPR, array<Type> NAA, matrix<Type> fracyr_SSB, vector<Type> F_init,  
-  matrix<Type> R_XSPR,
+vector< array <Type> > get_eq_curves(const vector<Type>& F_grid, array<Type>& sel, const vector<int>& spawn_seasons, const vector<int>& spawn_regions, 
+  const vector<int>& fleet_regions, const matrix<int>& fleet_seasons, const vector<Type>& fracyr_seasons, array<int>& can_move, const vector<int>& mig_type, 
+  const vector<Type>& fracyr_SSB, array<Type>& log_M, array<Type>& mu, const vector<Type>& L, array<Type>& mature, array<Type>& waa_ssb, 
+  array<Type>& waa_catch, vector<Type> SPR_weights, const vector<Type>& R_XSPR, int SPR_weight_type, int bias_correct, 
+  array<Type>& marg_NAA_sigma, int small_dim){
+  /* 
+    calculate equilibrium SSB/R, Y/R, SSB and yield at each full F in F_grid. All grid points are evaluated in the same pass over 
+    stocks, ages and seasons so that M, movement and can_move are extracted once and each PTM is shared by the SSB/R and Y/R 
+    calculations (same as get_SPR and get_YPR_srf with the same inputs).
+             F_grid: n_F; values of fully-selected F
+                sel: n_fleets x n_ages; selectivity (FAA/full F)
+       spawn_season: n_stocks; which season spawning occurs for each stock
+      spawn_regions: n_stocks; which region spawning occurs for each stock
+      fleet_regions: n_fleets; which region each fleet is operating
+      fleet_seasons: n_fleets x n_seasons; 0/1 indicating whether fleet is operating in the season
+     fracyr_seasons: n_seasons: length of intervals for each season
+           can_move: n_stocks x n_seasons x n_regions x n_regions: 0/1 determining whether movement can occur from one region to another
+           mig_type: n_stocks. 0 = migration after survival, 1 = movement and mortality simultaneous
+         fracyr_SSB: n_stocks:  size of interval from beginning of season to time of spawning within that season
+              log_M: n_stocks x n_regions x n_ages
+                 mu: n_stocks x n_ages x n_seasons x n_regions x n_regions array of movement matrices
+                  L: n_regions. "extra" unobserved mortality
+             mature: n_stocks x n_ages proportion mature at age
+            waa_ssb: n_stocks x n_ages. weight at age
+          waa_catch: n_fleets x n_ages. weight at age
+        SPR_weights: n_stocks; weights for aggregate SSB/R and Y/R (replaced by R_XSPR/sum(R_XSPR) if SPR_weight_type = 0)
+             R_XSPR: n_stocks; recruitment used to define equilibrium SSB and yield
+          small_dim: 0/1 telling whether the n_regions is "small." Different methods of inverting matrices.
+  */
+  int n_F = F_grid.size();
+  int n_stocks = log_M.dim(0);
+  int n_regions = log_M.dim(1);
+  int n_ages = log_M.dim(2);
+  int n_fleets = sel.dim(0);
+  int n_seasons = can_move.dim(1);
+  int P_dim = n_regions + n_fleets + 1;
+  if(SPR_weight_type == 0) SPR_weights = R_XSPR/R_XSPR.sum();
+
+  matrix<Type> I(P_dim,P_dim);
+  I.setZero();
+  for(int i = 0; i < P_dim; i++) I(i,i) = 1.0;
+  matrix<Type> W(n_fleets,n_fleets);
+  W.setZero();
+
+  array<Type> SPR(n_F,n_stocks+1), YPR(n_F,n_stocks+1), SSB(n_F,n_stocks+1), Y(n_F,n_fleets+n_regions+1);
+  SPR.setZero(); YPR.setZero(); SSB.setZero(); Y.setZero();
+  for(int s = 0; s < n_stocks; s++) {
+    int r_s = spawn_regions(s)-1;
+    vector< matrix<Type> > cum_S_ya(n_F); //cumulative survival up to age a for each F
+    for(int k = 0; k < n_F; k++) cum_S_ya(k) = get_S(I, n_regions);
+    for(int a = 0; a < n_ages; a++) {
+      vector<Type> M_t(n_regions);
+      for(int r = 0; r < n_regions; r++) M_t(r) = exp(log_M(s,r,a));
+      for(int i = 0; i < n_fleets; i++) W(i,i) = waa_catch(i,a);
+      vector< matrix<Type> > P_ya(n_F), P_spawn(n_F); //PTM for age and up to time of spawning for each F
+      for(int k = 0; k < n_F; k++) {
+        P_ya(k) = I;
+        P_spawn(k) = I;
+      }
+      for(int t = 0; t < n_seasons; t++) {
+        matrix<Type> mu_t(n_regions,n_regions);
+        mu_t.setZero();
+        matrix<int> can_move_t(n_regions, n_regions);
+        can_move_t.setZero();
+        if(n_regions>1) for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++) {
+          can_move_t(r,rr) = can_move(s,t,r,rr);
+          mu_t(r,rr) = mu(s,a,t,r,rr);
+        }
+        for(int k = 0; k < n_F; k++) {
+          vector<Type> F_t(n_fleets);
+          F_t.setZero();
+          for(int f = 0; f < n_fleets; f++) if(fleet_seasons(f,t)) F_t(f) = sel(f,a) * F_grid(k);
+          if(t == spawn_seasons(s)-1) P_spawn(k) = P_ya(k) * get_P_t_base(fleet_regions, can_move_t, mig_type(s), fracyr_SSB(s), F_t, M_t, 
+            mu_t, L);
+          P_ya(k) = P_ya(k) * get_P_t_base(fleet_regions, can_move_t, mig_type(s), fracyr_seasons(t), F_t, M_t, mu_t, L);
+        }
+      }
+      for(int k = 0; k < n_F; k++) {
+        matrix<Type> NPR_ya = cum_S_ya(k); //eq abundance at age a/recruit (Jan 1)
+        matrix<Type> S_ya = get_S(P_ya(k), n_regions);
+        if(bias_correct) for(int i = 0; i < n_regions; i++) for(int j = 0; j < n_regions; j++) {
+          int abc = a;
+          if(a < n_ages-1) abc += 1;
+          S_ya(i,j) = S_ya(i,j) * exp(-0.5*pow(marg_NAA_sigma(s,j,abc),2)); 
+        }
+        if(a < n_ages-1) cum_S_ya(k) = cum_S_ya(k) * S_ya; //accumulate for next age
+        else { //plus group
+          matrix<Type> fundm = get_S(I, n_regions) - S_ya;
+          if(small_dim) fundm = fundm.inverse(); else fundm = atomic::matinv(fundm); //fundm = (I - S_y,+)^-1
+          cum_S_ya(k) = cum_S_ya(k) * fundm;
+          NPR_ya = cum_S_ya(k);
+        }
+        matrix<Type> SPR_ya = NPR_ya * get_S(P_spawn(k), n_regions) * mature(s,a) * waa_ssb(s,a);
+        matrix<Type> YPR_ya = NPR_ya * get_D(P_ya(k), n_regions, n_fleets) * W; //n_regions x n_fleets
+        SPR(k,s) += SPR_ya(r_s,r_s);
+        for(int f = 0; f < n_fleets; f++) {
+          YPR(k,s) += YPR_ya(r_s,f);
+          Y(k,f) += R_XSPR(s) * YPR_ya(r_s,f);
+          Y(k,n_fleets+fleet_regions(f)-1) += R_XSPR(s) * YPR_ya(r_s,f);
+          Y(k,n_fleets+n_regions) += R_XSPR(s) * YPR_ya(r_s,f);
+        }
+      }
+    }
+    for(int k = 0; k < n_F; k++) {
+      SSB(k,s) = R_XSPR(s) * SPR(k,s);
+      SPR(k,n_stocks) += SPR_weights(s) * SPR(k,s);
+      YPR(k,n_stocks) += SPR_weights(s) * YPR(k,s);
+      SSB(k,n_stocks) += SSB(k,s);
+    }
+  }
+  vector< array<Type> > res(4);
+  res(0) = SPR; //n_F x (n_stocks + 1): SSB/R by stock and weighted total
+  res(1) = YPR; //n_F x (n_stocks + 1): Y/R (across fleets) by stock and weighted total
+  res(2) = SSB; //n_F x (n_stocks + 1): SSB by stock and total
+  res(3) = Y; //n_F x (n_fleets + n_regions + 1): yield by fleet, region, and total
+  return res;
+}
+
+template <class Type>
+vector< array <Type> > get_annual_SPR_res(const vector<Type>& SPR_weights, array<Type>& log_M, array<Type>& FAA, const vector<int>& spawn_seasons,  
+  const vector<int>& spawn_regions,
+  const vector<int>& fleet_regions, 
+  const matrix<int>& fleet_seasons,
+  const vector<Type>& fracyr_seasons,
+  array<int>& can_move,
+  array<int>& must_move,
+  const vector<int>& mig_type,
+  array<Type>& trans_mu_base, 
+  const matrix<Type>& L,
+  const vector<int>& which_F_age, array<Type>& waa_ssb, array<Type>& waa_catch,
+  array<Type>& mature, const vector<Type>& percentSPR, array<Type>& NAA, const matrix<Type>& fracyr_SSB, const vector<Type>& F_init,  
+  const matrix<Type>& R_XSPR,
   int small_dim, int SPR_weight_type, 
   int bias_correct,
-  array<Type> marg_NAA_sigma,
+  array<Type>& marg_NAA_sigma,
   int trace = 0, int n_iter = 10){
   int ny = which_F_age.size();
   int n_fleets = waa_catch.dim(0);
   int n_regions = can_move.dim(2);
   int n_stocks = waa_ssb.dim(0);
   int n_ages = mature.dim(2);
-  vector< array <Type>> all_res(7);
+  int n_targets = percentSPR.size();
+  vector< array <Type>> all_res(10);
   array<Type> log_FAA_XSPR(n_fleets+n_regions+1,ny,n_ages); //log FAA_XSPR, FAA_XSPR_tot
   array<Type> log_SSB_XSPR(ny,n_stocks+1); //log SSB_XSPR, SSB_XSPR_tot
   array<Type> log_Y_XSPR(ny, n_fleets+n_regions+1); //log Y_XSPR, Y_XSPR_r, Y_XSPR_tot
@@ -1011,6 +1276,9 @@ vector< array <Type> > get_annual_SPR_res(vector<Type> SPR_weights, array<Type>
   array<Type> log_SPR0(ny,n_stocks+1); //log SPR0
   array<Type> log_YPR_XSPR(n_stocks,n_fleets+1,ny); //log YPR at FXSPR by stock and fleet and total across fleets by stock
   array<Type> log_FXSPR_iter(ny,n_iter); //log FXSPR_iter
+  array<Type> log_FXSPR_multi(ny,n_targets); //log FXSPR for each X%SPR target
+  array<Type> log_SSB_XSPR_multi(ny,n_stocks+1,n_targets); //log SSB_XSPR, SSB_XSPR_tot for each X%SPR target
+  array<Type> log_Y_XSPR_multi(ny,n_fleets+n_regions+1,n_targets); //log Y_XSPR, Y_XSPR_r, Y_XSPR_tot for each X%SPR target
   //get inputs for each years
   vector<int> yvec(1);
 
@@ -1035,6 +1303,11 @@ vector< array <Type> > get_annual_SPR_res(vector<Type> SPR_weights, array<Type>
       for(int f = 0; f <= n_fleets; f++) log_YPR_XSPR(s,f,y) = SPR_res_y(5)(s,f);
     }
     for(int i = 0; i < n_iter; i++) log_FXSPR_iter(y,i) = SPR_res_y(6)(0,i);
+    for(int k = 0; k < n_targets; k++) {
+      log_FXSPR_multi(y,k) = SPR_res_y(17)(0,k);
+      for(int s = 0; s <= n_stocks; s++) log_SSB_XSPR_multi(y,s,k) = SPR_res_y(18)(k,s);
+      for(int f = 0; f <= n_fleets+n_regions; f++) log_Y_XSPR_multi(y,f,k) = SPR_res_y(19)(k,f);
+    }
   }
   
   all_res(0) = log_FAA_XSPR;
@@ -1044,22 +1317,30 @@ vector< array <Type> > get_annual_SPR_res(vector<Type> SPR_weights, array<Type>
   all_res(4) = log_SPR0;
   all_res(5) = log_YPR_XSPR;
   all_res(6) = log_FXSPR_iter; 
+  all_res(7) = log_FXSPR_multi;
+  all_res(8) = log_SSB_XSPR_multi;
+  all_res(9) = log_Y_XSPR_multi;
   return all_res;
 }
 
 template <class Type>
-array <Type> get_annual_SPR0_at_age(array<Type> log_M, vector<int> spawn_seasons,  
-  vector<Type> fracyr_seasons,
-  array<int> can_move,
-  array<int> must_move,
-  vector<int> mig_type,
-  array<Type> trans_mu_base, 
-  matrix<Type> L,
-  array<Type> waa_ssb, 
-  array<Type> mature, matrix<Type> fracyr_SSB,
+array <Type> get_annual_SPR0_at_age(array<Type>& log_M, const vector<int>& spawn_seasons,  
+  const vector<Type>& fracyr_seasons,
+  array<int>& can_move,
+  array<int>& must_move,
+  const vector<int>& mig_type,
+  array<Type>& trans_mu_base, 
+  const matrix<Type>& L,
+  array<Type>& waa_ssb, 
+  array<Type>& mature, const matrix<Type>& fracyr_SSB,
   int bias_correct,
-  array<Type> marg_NAA_sigma,
+  array<Type>& marg_NAA_sigma,
+  int process_by_year,
   int small_dim, int trace = 0){
+  /*
+    process_by_year: 0/1 whether M, movement, or extra mortality (L) differ by year. If 0, SPR0 at age is only calculated for years
+      where the maturity, weight at age, or spawning fraction (data) differ from the first year and copied otherwise.
+  */
   
   int ny = log_M.dim(2);
   int n_seasons = fracyr_seasons.size();
@@ -1080,6 +1361,10 @@ array <Type> get_annual_SPR0_at_age(array<Type> log_M, vector<int> spawn_seasons
   // see(n_stocks);
   // see(n_regions);
   // see(n_ages);
+  yvec(0) = 0;
+  vector<Type> ssbfrac0 = get_avg_ssbfrac(fracyr_SSB,yvec);
+  array<Type> waa_ssb0 = get_avg_mat_as_array(waa_ssb, yvec);
+  array<Type> mat0 = get_avg_mat_as_array(mature, yvec);
   for(int y = 0; y < ny; y++){
     yvec(0) = y;
     //get average inputs over specified years
@@ -1092,6 +1377,18 @@ array <Type> get_annual_SPR0_at_age(array<Type> log_M, vector<int> spawn_seasons
     // see(L_avg);
     array<Type> mat = get_avg_mat_as_array(mature,yvec);
     // see(mat);
+    if(!process_by_year && (y > 0)){
+      int same = 1;
+      for(int i = 0; i < ssbfrac.size(); i++) if(asDouble(ssbfrac(i)) != asDouble(ssbfrac0(i))) same = 0;
+      for(int i = 0; i < mat.size(); i++) if(asDouble(mat(i)) != asDouble(mat0(i))) same = 0;
+      for(int i = 0; i < waa_ssb_avg.size(); i++) if(asDouble(waa_ssb_avg(i)) != asDouble(waa_ssb0(i))) same = 0;
+      if(same) { //all inputs are the same as the first year
+        for(int s = 0; s < n_stocks; s++) for(int a = 0; a < n_ages; a++)for(int r = 0; r < n_regions; r++) for(int rr = 0; rr < n_regions; rr++){
+          SPR0AA(y,s,a,r,rr) = SPR0AA(0,s,a,r,rr);
+        }
+        continue;
+      }
+    }
     array<Type> log_M_avg = get_avg_M(log_M, yvec, 1);
     // see(log_M_avg.dim);
     array<Type> mu_avg(n_stocks, n_ages, n_seasons, n_regions, n_regions);